@@ -0,0 +1,516 @@
+/*!
+ *  @file bench.cpp
+ *  @brief Benchmark File
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the benchmark main function
+ */
+
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "arena.hpp"
+#include "driver.hpp"
+#include "editable_expression.hpp"
+#include "expression.hpp"
+#include "input.hpp"
+#include "kernels.hpp"
+#include "lexer.hpp"
+#include "output.hpp"
+#include "profiler.hpp"
+
+//! The number of heap allocations (counted by the operator new below)
+static std::atomic<unsigned long> allocations{0};
+
+/**
+ * @brief Allocate memory, counting the allocation
+ * @param _size The number of bytes
+ * @return A pointer to the allocated memory
+ */
+void *operator new(std::size_t _size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *_p = std::malloc(_size ? _size : 1))
+        return _p;
+    throw std::bad_alloc();
+}
+
+/**
+ * @brief Allocate aligned memory, counting the allocation
+ * @param _size The number of bytes
+ * @param _align The alignment
+ * @return A pointer to the allocated memory
+ */
+void *operator new(std::size_t _size, std::align_val_t _align) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    auto _alignment = static_cast<std::size_t>(_align);
+    _size = (_size + _alignment - 1) / _alignment * _alignment;
+    if (void *_p = std::aligned_alloc(_alignment, _size ? _size : _alignment))
+        return _p;
+    throw std::bad_alloc();
+}
+
+/**
+ * @brief Deallocate memory
+ * @param _p The memory
+ */
+void operator delete(void *_p) noexcept {
+    std::free(_p);
+}
+
+/**
+ * @brief Deallocate memory
+ * @param _p The memory
+ */
+void operator delete(void *_p, std::size_t) noexcept {
+    std::free(_p);
+}
+
+/**
+ * @brief Deallocate aligned memory
+ * @param _p The memory
+ */
+void operator delete(void *_p, std::align_val_t) noexcept {
+    std::free(_p);
+}
+
+/**
+ * @brief Deallocate aligned memory
+ * @param _p The memory
+ */
+void operator delete(void *_p, std::size_t, std::align_val_t) noexcept {
+    std::free(_p);
+}
+
+/**
+ * @brief The memory used by allocations_run
+ */
+enum Memory {
+    HEAP,   //!< A new Expression by line, on the heap
+    ARENA,  //!< A new Expression by line, on an Arena reset after each line
+    REUSED  //!< A single Expression, reset to each line
+};
+
+/**
+ * @brief Evaluate all lines on a single thread, counting the allocations
+ * @param _lines The lines
+ * @param _mode The evaluation mode
+ * @param _memory The memory used by the evaluation
+ */
+static void allocations_run(const std::vector<std::string_view> &_lines,
+                            Expression::Mode _mode, Memory _memory) {
+    static const char *names[] = {"heap", "arena", "reused"};
+    Result result;
+    Arena arena;
+    Expression reused;
+    unsigned long before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &_line : _lines) {
+        if (_memory == REUSED) {
+            reused.reset(_line);
+            reused.calculate(result, _mode);
+        } else if (_memory == ARENA) {
+            Expression expr(_line, &arena);
+            expr.calculate(result, _mode);
+            arena.reset();
+        } else {
+            Expression expr(_line);
+            expr.calculate(result, _mode);
+        }
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::cout << (_mode == Expression::FUSED ? "fused" : "phased") << ","
+              << names[_memory] << "," << _lines.size() << ","
+              << allocations.load() - before << "," << elapsed.count() << "\n";
+}
+
+/**
+ * @brief Generate a random expression
+ * @param _rng The random numbers generator
+ * @param _depth The current nesting depth
+ * @return A string with the expression
+ */
+static std::string random_expression(std::mt19937 &_rng, int _depth = 0) {
+    static const char operators[] = "+-*/%^";
+    if (_depth > 3 || _rng() % 3 == 0)
+        return std::to_string(_rng() % 1000);
+    if (_rng() % 4 == 0)
+        return "(" + random_expression(_rng, _depth + 1) + ")";
+    return random_expression(_rng, _depth + 1) + " " + operators[_rng() % 6] +
+           " " + random_expression(_rng, _depth + 1);
+}
+
+/**
+ * @brief Lex all lines, counting the terms
+ * @param _corpus The lines name
+ * @param _lines The lines
+ * @param _scan Flag to scan the lines first (with the Kernels instruction
+ * set in use), instead of lexing them byte by byte
+ */
+static void lexer_run(const char *_corpus,
+                      const std::vector<std::string> &_lines, bool _scan) {
+    static const char *isas[] = {"scalar", "sse4.1", "avx2"};
+    std::vector<std::uint64_t> starts;
+    unsigned long bytes = 0, terms = 0;
+    auto _count = [&terms](const Term &) {
+        terms++;
+        return true;
+    };
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &_line : _lines) {
+        Lexer lexer(_line);
+        if (_scan) {
+            starts.resize((_line.size() + 63) / 64);
+            Kernels::scan(_line.data(), _line.size(), starts.data());
+            lexer.lex(starts.data(), _count,
+                      [](unsigned, unsigned &, int &) { return false; });
+        } else {
+            lexer.lex(_count);
+        }
+        bytes += _line.size();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::cout << _corpus << "," << (_scan ? "scan" : "bytes") << ","
+              << (_scan ? isas[Kernels::isa()] : "-") << "," << bytes << ","
+              << terms << "," << elapsed.count() << ","
+              << bytes / elapsed.count() / 1e6 << "\n";
+}
+
+/**
+ * @brief A Profiler that also counts the allocations of each phase
+ */
+class AllocationsProfiler : public Profiler {
+ public:
+    /**
+     * @brief Start measuring a phase
+     * @param _phase The phase
+     */
+    void start(Phase _phase) override {
+        m_before = allocations.load();
+        Profiler::start(_phase);
+    }
+
+    /**
+     * @brief Stop measuring a phase
+     * @param _phase The phase
+     */
+    void stop(Phase _phase) override {
+        Profiler::stop(_phase);
+        m_allocations[_phase] += allocations.load() - m_before;
+    }
+
+    /**
+     * @brief Gets the allocations of a phase
+     * @param _phase The phase
+     * @return The number of allocations
+     */
+    unsigned long allocated(Phase _phase) const {
+        return m_allocations[_phase];
+    }
+
+ private:
+    unsigned long m_before = 0;                  //!< The allocations before
+    unsigned long m_allocations[PHASES] = {};    //!< The allocations by phase
+};
+
+/**
+ * @brief Print a row of the phases suite
+ * @param _workload The workload name
+ * @param _phase The phase name
+ * @param _lines The number of lines
+ * @param _nanoseconds The time spent by all lines
+ * @param _allocations The allocations of all lines
+ */
+static void phase_row(const char *_workload, const char *_phase,
+                      unsigned _lines, double _nanoseconds,
+                      unsigned long _allocations) {
+    std::cout << _workload << "," << _phase << "," << _lines << ","
+              << _nanoseconds / _lines << ","
+              << (_nanoseconds > 0 ? _lines / (_nanoseconds / 1e9) : 0) << ","
+              << _allocations << "\n";
+}
+
+/**
+ * @brief Evaluate a workload, timing each phase and the whole calculate
+ * @param _workload The workload name
+ * @param _lines The workload lines
+ *
+ * The lines are evaluated once before (by a single Expression, reset to
+ * each line), so the times and allocations are of the steady state.
+ */
+static void phases_run(const char *_workload,
+                       const std::vector<std::string> &_lines) {
+    Expression expr;
+    Result result;
+    for (const auto &_line : _lines)
+        for (auto mode : {Expression::PHASED, Expression::FUSED}) {
+            expr.reset(_line);
+            expr.calculate(result, mode);
+        }
+
+    AllocationsProfiler profiler;
+    for (const auto &_line : _lines) {
+        expr.reset(_line);
+        expr.calculate(result, profiler);
+    }
+    for (auto phase : {Profiler::TOKENIZE, Profiler::INFIX2POSTFIX,
+                       Profiler::GET_RESULT})
+        phase_row(_workload, Profiler::name(phase), _lines.size(),
+                  profiler.nanoseconds(phase), profiler.allocated(phase));
+
+    unsigned long before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &_line : _lines) {
+        expr.reset(_line);
+        expr.calculate(result);
+    }
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    phase_row(_workload, "calculate", _lines.size(), elapsed.count(),
+              allocations.load() - before);
+}
+
+/**
+ * @brief Generate a deeply nested expression
+ * @param _rng The random numbers generator
+ * @param _depth The nesting depth
+ * @return A string with the expression
+ */
+static std::string nested_expression(std::mt19937 &_rng, int _depth) {
+    if (_depth == 0)
+        return std::to_string(_rng() % 100);
+    return "(" + nested_expression(_rng, _depth - 1) +
+           (_rng() % 2 ? " + " : " - ") + std::to_string(_rng() % 100) + ")";
+}
+
+/**
+ * @brief Generate a long chain of operators, without parentheses
+ * @param _rng The random numbers generator
+ * @param _operands The number of operands
+ * @return A string with the expression
+ */
+static std::string chain_expression(std::mt19937 &_rng, int _operands) {
+    static const char operators[] = "+-+-*/%";
+    std::string _expr = std::to_string(_rng() % 100);
+    for (auto i(1); i < _operands; i++)
+        _expr += std::string(" ") + operators[_rng() % 7] + " " +
+                 std::to_string(_rng() % 100 + 1);
+    return _expr;
+}
+
+/**
+ * @brief Generate an expression with an error
+ * @param _rng The random numbers generator
+ * @param _error The error id (0 to 8, i.e. E1 to E9)
+ * @return A string with the expression
+ */
+static std::string error_expression(std::mt19937 &_rng, int _error) {
+    std::string _expr = random_expression(_rng);
+    switch (_error) {
+        case 0: return _expr + " + 40000";
+        case 1: return _expr + " +";
+        case 2: return _expr + " + $";
+        case 3: return _expr + " 7";
+        case 4: return _expr + ")";
+        case 5: return "* " + _expr;
+        case 6: return "(" + _expr;
+        case 7: return "(" + _expr + ") / 0";
+        default: return "32767 * 2 + " + _expr;
+    }
+}
+
+/**
+ * @brief Time each phase on each synthetic workload
+ * @param _lines The number of lines of each workload
+ *
+ * Prints a row by workload and phase (tokenize, infix2postfix, get_result
+ * and the whole calculate, in the default mode), with the time by line, the
+ * lines by second and the allocations. The workloads are short lines, deep
+ * nesting, long operator chains, lines with errors (of each code) and a few
+ * lines repeated.
+ */
+static void phases_suite(unsigned _lines) {
+    std::mt19937 rng(42);
+    std::vector<std::pair<const char *, std::function<std::string(unsigned)>>>
+        workloads = {
+            {"short", [&rng](unsigned) { return random_expression(rng); }},
+            {"deep", [&rng](unsigned) { return nested_expression(rng, 48); }},
+            {"chain", [&rng](unsigned) { return chain_expression(rng, 64); }},
+            {"errors",
+             [&rng](unsigned i) { return error_expression(rng, i % 9); }},
+            {"repeated", [](unsigned i) {
+                 std::mt19937 _rng(i % 16);
+                 return random_expression(_rng);
+             }}};
+
+    std::cout << "workload,phase,lines,ns_per_line,lines_per_sec,allocations"
+              << "\n";
+    for (const auto &_workload : workloads) {
+        std::vector<std::string> _input(_lines);
+        for (auto i(0u); i < _lines; i++)
+            _input[i] = _workload.second(i);
+        phases_run(_workload.first, _input);
+    }
+}
+
+/**
+ * @brief Time the edits of long lines, against evaluating them again
+ *
+ * Prints a row by line size (from 1 KiB to 1 MiB, a long sum) with the time of an edit and its calculate on an
+ * EditableExpression, and of a calculate of the whole line on an
+ * Expression. Each edit replaces a number by another one (never 0, so
+ * there is no division by zero).
+ */
+static void edits_suite() {
+    std::cout << "chars,edits,us_per_edit,us_per_calculate\n";
+    for (std::size_t _size = 1024; _size <= 1024 * 1024; _size *= 4) {
+        // Terms in [-9, 9], so the sum stays in range
+        std::mt19937 _rng(42);
+        std::string _line;
+        while (_line.size() < _size) {
+            if (!_line.empty())
+                _line += _rng() % 2 ? " + " : " - ";
+            _line += std::to_string(_rng() % 10) + " * (" +
+                     std::to_string(_rng() % 10) + " - " +
+                     std::to_string(_rng() % 10) + ") / 9";
+        }
+        // The positions of the numbers (all have a single digit)
+        std::vector<std::size_t> _digits;
+        for (auto i(0u); i < _line.size(); i++)
+            if (std::isdigit(static_cast<unsigned char>(_line[i])))
+                _digits.push_back(i);
+
+        EditableExpression _editable(_line);
+        Result _result;
+        _editable.calculate(_result);
+        const unsigned _edits = 10000;
+        auto _start = std::chrono::steady_clock::now();
+        for (auto i(0u); i < _edits; i++) {
+            _editable.edit(_digits[_rng() % _digits.size()], 1,
+                           std::string(1, '1' + _rng() % 9));
+            _editable.calculate(_result);
+        }
+        std::chrono::duration<double, std::micro> _edit_time =
+            std::chrono::steady_clock::now() - _start;
+
+        Expression _expr(_editable.text());
+        const unsigned _runs = 20;
+        _start = std::chrono::steady_clock::now();
+        for (auto i(0u); i < _runs; i++)
+            _expr.calculate(_result);
+        std::chrono::duration<double, std::micro> _full_time =
+            std::chrono::steady_clock::now() - _start;
+
+        std::cout << _line.size() << "," << _edits << ","
+                  << _edit_time.count() / _edits << ","
+                  << _full_time.count() / _runs << "\n";
+    }
+}
+
+/**
+ * @brief Main function
+ *
+ * Evaluates the same synthetic input with 1, 2, 4, ... threads (up to the
+ * number of hardware threads) and prints the throughput of each run. Then
+ * compares the heap allocations of each mode, with and without an Arena, and
+ * with a single Expression reset to each line. Then lexes a few long lines
+ * byte by byte and scanned by each supported instruction set. At last, times
+ * each phase on each synthetic workload (see phases_suite), and the edits
+ * of long lines (see edits_suite).
+ *
+ * Usage: bench [lines] [max_threads]
+ *        bench phases [lines] (only the phases suite, as a single table)
+ *        bench edits (only the edits suite)
+ */
+int main(int argc, char const *argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "phases") == 0) {
+        phases_suite(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000);
+        return EXIT_SUCCESS;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "edits") == 0) {
+        edits_suite();
+        return EXIT_SUCCESS;
+    }
+
+    unsigned lines = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    unsigned max_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+                                    : std::thread::hardware_concurrency();
+    max_threads = max_threads ? max_threads : 1;
+
+    // Build the input once, so all runs evaluate the same lines
+    std::mt19937 rng(42);
+    std::string input;
+    for (auto i(0u); i < lines; i++)
+        input += random_expression(rng) + "\n";
+
+    std::cout << "threads,lines,seconds,lines_per_sec,speedup\n";
+    double base = 0;
+    for (auto threads(1u); threads <= max_threads; threads *= 2) {
+        Input in(input.data(), input.size());
+        Output out("/dev/null");
+
+        auto start = std::chrono::steady_clock::now();
+        Driver(threads).run(in, out);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        double seconds = elapsed.count();
+        base = threads == 1 ? seconds : base;
+        std::cout << threads << "," << lines << "," << seconds << ","
+                  << lines / seconds << "," << base / seconds << "\n";
+    }
+
+    // The lines are views of the input
+    std::vector<std::string_view> views;
+    std::string_view line;
+    Input in(input.data(), input.size());
+    while (in.next(line))
+        views.push_back(line);
+
+    std::cout << "\nmode,memory,lines,allocations,seconds\n";
+    for (auto mode : {Expression::PHASED, Expression::FUSED})
+        for (auto memory : {HEAP, ARENA, REUSED})
+            allocations_run(views, mode, memory);
+
+    // Long lines, of a sum of random expressions: dense (as the lines
+    // above) and spaced (with runs of whitespaces around the sums)
+    std::vector<std::string> dense(32), spaced(32);
+    for (auto i(0u); i < dense.size(); i++) {
+        dense[i] = spaced[i] = random_expression(rng);
+        while (dense[i].size() < 256 * 1024)
+            dense[i] += " + " + random_expression(rng);
+        while (spaced[i].size() < 256 * 1024)
+            spaced[i] += "        +        " + random_expression(rng);
+    }
+
+    std::cout << "\ncorpus,lexer,isa,bytes,terms,seconds,mb_per_sec\n";
+    for (auto corpus : {&dense, &spaced}) {
+        const char *name = corpus == &dense ? "dense" : "spaced";
+        lexer_run(name, *corpus, false);
+        for (auto isa : {Kernels::SCALAR, Kernels::SSE, Kernels::AVX2})
+            if (Kernels::select(isa))
+                lexer_run(name, *corpus, true);
+    }
+
+    std::cout << "\n";
+    phases_suite(lines / 10 ? lines / 10 : 1);
+
+    std::cout << "\n";
+    edits_suite();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/*!
+ *  @file arena.hpp
+ *  @brief Arena Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Arena Class header
+ */
+
+#ifndef _arena_hpp_
+#define _arena_hpp_
+
+#include <cstddef>
+#include <memory_resource>
+
+/**
+ * @brief Arena Class
+ *
+ * A monotonic memory resource: allocations take the next bytes of a block,
+ * deallocations do nothing and everything is released at once by reset.
+ * The blocks are kept across resets, so a warm Arena doesn't allocate.
+ * It's used (through std::pmr::polymorphic_allocator) by one thread only.
+ */
+class Arena : public std::pmr::memory_resource {
+ public:
+    //! The default block size
+    static const std::size_t BLOCK_SIZE = 1 << 16;
+
+    /**
+     * @brief Arena Constructor
+     * @param _block_size The size of each block (default = BLOCK_SIZE)
+     */
+    explicit Arena(std::size_t _block_size = BLOCK_SIZE);
+
+    /**
+     * @brief Arena Destructor
+     *
+     * Delete all blocks
+     */
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * @brief Release all allocations, keeping the blocks
+     *
+     * Everything allocated before is invalid after it
+     */
+    void reset();
+
+    /**
+     * @brief Get the number of blocks
+     * @return The number of blocks allocated from the heap
+     */
+    std::size_t blocks() const;
+
+ private:
+    /**
+     * @brief The Block header (followed by the block bytes)
+     */
+    struct Block {
+        Block *next;       //!< The next block
+        std::size_t size;  //!< The block bytes size
+    };
+
+    /**
+     * @brief Allocate bytes from the current block (or a next one)
+     * @param _bytes The number of bytes
+     * @param _align The alignment
+     * @return A pointer to the allocated bytes
+     */
+    void *do_allocate(std::size_t _bytes, std::size_t _align) override;
+
+    /**
+     * @brief Deallocate bytes (does nothing, see reset)
+     */
+    void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+    /**
+     * @brief Verify if two resources are the same
+     * @param _other The other resource
+     * @return True if it's this Arena, False otherwise
+     */
+    bool do_is_equal(const std::pmr::memory_resource &_other) const
+        noexcept override;
+
+    /**
+     * @brief Start allocating from a block
+     * @param _block The block
+     */
+    void use(Block *_block);
+
+    std::size_t m_block_size;       //!< The size of each block
+    std::size_t m_blocks = 0;       //!< The number of blocks
+    Block *m_first   = nullptr;     //!< The first block
+    Block *m_current = nullptr;     //!< The block being used
+    char *m_pos      = nullptr;     //!< The next free byte
+    char *m_end      = nullptr;     //!< The end of the block being used
+};
+
+#endif
@@ -0,0 +1,167 @@
+/*!
+ *  @file arithmetic.hpp
+ *  @brief Arithmetic Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Arithmetic Class header
+ */
+
+#ifndef _arithmetic_hpp_
+#define _arithmetic_hpp_
+
+#include <limits>
+
+#include "numeric.hpp"
+
+/**
+ * @brief Arithmetic Class
+ *
+ * The operations applied by the evaluators (don't need to be instanciated),
+ * entirely on integers: the sums and products are checked for overflow by
+ * the compiler builtins, and the power is computed by squaring.
+ *
+ * The Policy (see numeric.hpp) gives the values type and range, so the
+ * range checks of a policy that uses the whole type are optimized out.
+ */
+template <typename Policy>
+class BasicArithmetic {
+ public:
+    typedef typename Policy::value_type value_type;  //!< The values type
+
+    /**
+     * @brief Arithmetic Constructor
+     *
+     * Delete Constructor
+     */
+    BasicArithmetic() = delete;
+
+    /**
+     * @brief Arithmetic Destructor
+     *
+     * Delete Destructor
+     */
+    ~BasicArithmetic() = delete;
+
+    /**
+     * @brief Verify if a value is a valid number
+     * @param _val The value to be used on function
+     * @return True if is valid, False otherwise
+     *
+     * Verify if is a valid number (in range [Policy::min, Policy::max])
+     */
+    static constexpr bool is_valid_number(value_type _val) {
+        return _val >= Policy::min and _val <= Policy::max;
+    }
+
+    /**
+     * @brief Raise a value to a power
+     * @param _base The base
+     * @param _exp The exponent
+     * @param _rst The var to keep the result
+     *
+     * The result of a negative exponent is truncated to an integer (so it's
+     * 0, unless the base is 1 or -1), as the division by zero of 0 to a
+     * negative power is an overflow.
+     *
+     * @return True if the result is a valid number, False otherwise
+     */
+    static constexpr bool power(value_type _base, value_type _exp, value_type &_rst) {
+        // The bases whose powers never grow
+        if (_base == 0) {
+            _rst = _exp == 0 ? 1 : 0;
+            return _exp >= 0;
+        }
+        if (_base == 1 || _base == -1) {
+            _rst = _base == -1 && _exp % 2 != 0 ? -1 : 1;
+            return true;
+        }
+        if (_exp < 0) {
+            _rst = 0;
+            return true;
+        }
+
+        // Square the base by each exponent bit, until the result overflows
+        value_type _acc = 1;
+        while (true) {
+            if (_exp & 1) {
+                if (__builtin_mul_overflow(_acc, _base, &_acc) ||
+                    !is_valid_number(_acc))
+                    return false;
+            }
+            _exp >>= 1;
+            if (_exp == 0)
+                break;
+            // A greater bit is left, so the result is at least the square
+            if (__builtin_mul_overflow(_base, _base, &_base) ||
+                !is_valid_number(_base))
+                return false;
+        }
+        _rst = _acc;
+        return true;
+    }
+
+    /**
+     * @brief Apply an operator on two values
+     * @param _op The operator symbol (+, -, /, *, ^, %)
+     * @param _v1 The first value of operation
+     * @param _v2 The second value of operation
+     * @param _rst The var to keep the result
+     * @param _error The var to keep the error id (if any)
+     *
+     * @return True if all succeed, False otherwise
+     */
+    static constexpr bool apply(int _op, value_type _v1, value_type _v2,
+                      value_type &_rst, int &_error) {
+        if (!is_valid_number(_v1) || !is_valid_number(_v2)) {
+            _error = 8;
+            return false;
+        }
+        bool _overflow = false;
+        switch (_op) {
+            case '^':
+                _overflow = !power(_v1, _v2, _rst);
+                break;
+            case '*':
+                _overflow = __builtin_mul_overflow(_v1, _v2, &_rst);
+                break;
+            case '/':
+                if (_v2 == 0) {
+                    _error = 7;
+                    return false;
+                }
+                // The minimum divided by -1 doesn't fit on the whole type
+                _overflow = _v2 == -1 && _v1 == lowest;
+                _rst = _overflow ? 0 : _v1 / _v2;
+                break;
+            case '%':
+                if (_v2 == 0) {
+                    _error = 7;
+                    return false;
+                }
+                _rst = _v2 == -1 ? 0 : _v1 % _v2;
+                break;
+            case '+':
+                _overflow = __builtin_add_overflow(_v1, _v2, &_rst);
+                break;
+            case '-':
+                _overflow = __builtin_sub_overflow(_v1, _v2, &_rst);
+                break;
+            default:
+                return false;
+        }
+        if (_overflow || !is_valid_number(_rst)) {
+            _error = 8;
+            return false;
+        }
+        return true;
+    }
+
+ private:
+    //! The type minimum value
+    static constexpr value_type lowest = std::numeric_limits<value_type>::min();
+};
+
+//! The operations of the default (16-bit) evaluator
+typedef BasicArithmetic<Int16> Arithmetic;
+
+#endif
@@ -0,0 +1,222 @@
+/*!
+ *  @file bares.hpp
+ *  @brief Compile Time Evaluation Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the constexpr evaluation of expressions
+ */
+
+#ifndef _bares_hpp_
+#define _bares_hpp_
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "lexer.hpp"
+#include "numeric.hpp"
+#include "result.hpp"
+#include "shunting_yard.hpp"
+#include "term.hpp"
+
+namespace bares {
+
+/**
+ * @brief Evaluator Class
+ *
+ * The single pass evaluation of the Expression (with the same Lexer and
+ * ShuntingYard, so the same precedences, operations and error ids), on
+ * Stacks of fixed size N, so it can run on constant expressions.
+ */
+template <typename Policy, unsigned N>
+class Evaluator {
+ public:
+    typedef typename Policy::value_type value_type;  //!< The numbers type
+    typedef BasicTerm<value_type> Term;              //!< The Term type
+    typedef BasicResult<value_type> Result;          //!< The Result type
+
+    /**
+     * @brief Evaluator Constructor
+     * @param _expr The expression text
+     */
+    constexpr explicit Evaluator(std::string_view _expr) : m_expr(_expr) {}
+
+    /**
+     * @brief Calculate the expression Result
+     * @return The expression Result (value or error)
+     */
+    constexpr Result calculate() {
+        BasicLexer<Policy> lexer(m_expr);
+        auto _reduce = [this](const Term &_t) {
+            if (!m_reduce_failed &&
+                !ShuntingYard::reduce(_t, m_operands, m_lhs, m_rhs,
+                                      m_error.id, m_error.col))
+                m_reduce_failed = true;
+            return true;
+        };
+        auto _shunt = [this, &_reduce](const Term &_t) {
+            return ShuntingYard::shunt(_t, m_operators, _reduce, m_error.id,
+                                       m_error.col);
+        };
+
+        Result _return;
+        if (!lexer.lex(_shunt)) {
+            // The Lexer error is found later on the line, so it takes
+            // precedence over the shunting and the evaluation errors
+            if (lexer.error_id() >= 0)
+                set_error(lexer.error_id(), lexer.error_col());
+        } else if (ShuntingYard::shunt_end(m_operators, _reduce, m_error.id,
+                                           m_error.col) &&
+                   !m_reduce_failed) {
+            Term _result;
+            m_operands.pop(_result);
+            _return.value = _result.value;
+            _return.empty = m_expr.empty();
+            return _return;
+        }
+        _return.error = m_error.id;
+        _return.col   = m_error.col;
+        return _return;
+    }
+
+ private:
+    typedef BasicShuntingYard<Policy> ShuntingYard;  //!< The shared core
+
+    /**
+     * @brief A Stack with N elements on a fixed array
+     */
+    struct FixedStack {
+        Term items[N];       //!< The elements
+        unsigned size = 0;   //!< The number of elements
+
+        // Push an element (a deeper expression can't be evaluated)
+        constexpr bool push(const Term &_x) {
+            if (size == N)
+                throw std::length_error("expression deeper than the Stack");
+            items[size++] = _x;
+            return true;
+        }
+        // Pop an element
+        constexpr bool pop(Term &_return) {
+            if (size == 0)
+                return false;
+            _return = items[--size];
+            return true;
+        }
+        // Gets the top element
+        constexpr bool top(Term &_return) const {
+            if (size == 0)
+                return false;
+            _return = items[size - 1];
+            return true;
+        }
+        // Verify if it's empty
+        constexpr bool isEmpty() const { return size == 0; }
+    };
+
+    /**
+     * @brief Function to set error
+     * @param _id The error id
+     * @param _col The error col
+     */
+    constexpr void set_error(const int _id, const int _col) {
+        m_error.id  = _id;
+        m_error.col = _col;
+    }
+
+    //! The error structure
+    struct {
+        int id = -1;   //!< The error code
+        int col = -1;  //!< The error column
+    } m_error;
+    std::string_view m_expr;        //!< The expression text
+    FixedStack m_operators;         //!< The operators Stack
+    FixedStack m_operands;          //!< The operands Stack
+    Term m_lhs;                     //!< The last left hand side operand
+    Term m_rhs;                     //!< The last right hand side operand
+    bool m_reduce_failed = false;   //!< Flag to indicate an evaluation error
+};
+
+/**
+ * @brief Calculate an expression Result
+ * @param _expr The expression text
+ * @return The expression Result (value or error, as Expression::calculate)
+ *
+ * Usable on constant expressions, for expressions up to N terms deep
+ */
+template <typename Policy = Int16, unsigned N = 64>
+constexpr BasicResult<typename Policy::value_type> calculate(
+    std::string_view _expr) {
+    return Evaluator<Policy, N>(_expr).calculate();
+}
+
+namespace detail {
+
+//! @name Errors
+//! One array by error: on a constant expression, an error is reported by
+//! reading past the end of its array, so the compiler shows the error and
+//! the column (e.g. "array subscript value '9' is outside the bounds of
+//! array 'bares::detail::E3_at_column'")
+//! @{
+constexpr bool E1_at_column[1] = {};  //!< Numeric constant out of range
+constexpr bool E2_at_column[1] = {};  //!< Ill-formed expression
+constexpr bool E3_at_column[1] = {};  //!< Invalid operand
+constexpr bool E4_at_column[1] = {};  //!< Extraneous symbol
+constexpr bool E5_at_column[1] = {};  //!< Mismatch ')'
+constexpr bool E6_at_column[1] = {};  //!< Lost operator
+constexpr bool E7_at_column[1] = {};  //!< Missing closing ')'
+constexpr bool E8_division_by_zero[1] = {};  //!< Division by zero
+constexpr bool E9_numeric_overflow[1] = {};  //!< Numeric overflow
+//! @}
+
+/**
+ * @brief Fail the evaluation of an invalid expression
+ * @param _error The error number (as printed, e.g. 3 for E3)
+ * @param _column The error column (as printed, from 1)
+ *
+ * On a constant expression it doesn't compile, otherwise it throws
+ * std::invalid_argument (e.g. "E3 at column 5")
+ */
+constexpr bool invalid_expression(int _error, int _column) {
+    if (__builtin_is_constant_evaluated()) {
+        switch (_error) {
+            case 1: return E1_at_column[_column];
+            case 2: return E2_at_column[_column];
+            case 3: return E3_at_column[_column];
+            case 4: return E4_at_column[_column];
+            case 5: return E5_at_column[_column];
+            case 6: return E6_at_column[_column];
+            case 7: return E7_at_column[_column];
+            case 8: return E8_division_by_zero[1];
+            case 9: return E9_numeric_overflow[1];
+        }
+    }
+    // As on the compiler message, the errors 8 and 9 have no column
+    throw std::invalid_argument(
+        "E" + std::to_string(_error) +
+        (_error <= 7 ? " at column " + std::to_string(_column) : ""));
+}
+
+}  // namespace detail
+
+/**
+ * @brief Evaluate an expression
+ * @param _expr The expression text
+ * @return The expression value
+ *
+ * On a constant expression (e.g. constexpr int x = bares::eval("3 * 2"))
+ * it's computed by the compiler, and an invalid expression doesn't compile.
+ * Otherwise it throws std::invalid_argument (with the error and its column,
+ * e.g. "E3 at column 5", or "E8" for the errors without a column).
+ */
+template <typename Policy = Int16, unsigned N = 64>
+constexpr typename Policy::value_type eval(std::string_view _expr) {
+    auto _result = calculate<Policy, N>(_expr);
+    if (_result.is_error())
+        detail::invalid_expression(_result.error + 1, _result.col + 1);
+    return _result.value;
+}
+
+}  // namespace bares
+
+#endif
@@ -0,0 +1,144 @@
+/*!
+ *  @file driver.hpp
+ *  @brief Driver Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Driver Class header
+ */
+
+#ifndef _driver_hpp_
+#define _driver_hpp_
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arena.hpp"
+#include "expression.hpp"
+#include "input.hpp"
+#include "output.hpp"
+#include "profiler.hpp"
+#include "result.hpp"
+#include "result_cache.hpp"
+
+/**
+ * @brief Driver Class
+ *
+ * Evaluates every line of an Input and writes the results, in the same
+ * order, on an Output. With more than one thread, the input
+ * is split in chunks of lines evaluated on a ThreadPool.
+ */
+class Driver {
+ public:
+    /**
+     * @brief Driver Constructor
+     * @param _threads The number of threads (default = 1)
+     * @param _cache The cache of results, shared by all threads (optional)
+     * @param _share Flag to evaluate equal subexpressions of a chunk once
+     * @param _profiler The Profiler of each phase (optional)
+     * @see Expression::calculate_batch
+     *
+     * Creates a Driver (0 threads means one per hardware thread). With a
+     * Profiler, the lines are evaluated one by one on the thread calling
+     * run (by phases, see Expression::calculate), so the threads and share
+     * options are ignored.
+     */
+    explicit Driver(unsigned _threads = 1, ResultCache *_cache = nullptr,
+                    bool _share = false, Profiler *_profiler = nullptr);
+
+    /**
+     * @brief Evaluate all lines
+     * @param _input The Input with one expression by line
+     * @param _output The Output to write the results
+     * @return True if all results were written, False otherwise
+     */
+    bool run(Input &_input, Output &_output);
+
+    /**
+     * @brief Get the number of threads
+     * @return The number of threads
+     */
+    unsigned threads() const;
+
+ private:
+    /**
+     * @brief The Chunk struct
+     */
+    struct Chunk {
+        std::vector<std::string_view> lines;  //!< The chunk expressions
+        std::string text;    //!< The lines copy (if the Input isn't stable)
+        std::string output;  //!< The chunk results
+        bool done = false;   //!< Flag to indicate it was evaluated
+    };
+
+    /**
+     * @brief The state reused by a worker across chunks
+     */
+    struct State {
+        //! The memory of the worker Expression buffers and batches, emptied
+        //! on each chunk (see recycle)
+        Arena arena;
+        //! The Expression reset to each line, keeping its buffers warm (so
+        //! it only takes memory from the Arena while they grow), and built
+        //! again on each chunk
+        std::optional<Expression> expr;
+        Result result;  //!< The result of the current line
+        std::vector<Result> results;          //!< The chunk lines results
+        std::vector<std::string_view> batch;  //!< The lines not cached
+        std::vector<Result> batch_results;    //!< The batch results
+        std::vector<unsigned> positions;      //!< The batch lines positions
+    };
+
+    /**
+     * @brief Read the next chunk of lines
+     * @param _input The Input
+     * @param _chunk The chunk to keep the lines
+     * @return True if the chunk is full, False at the end of input
+     */
+    bool read(Input &_input, Chunk &_chunk);
+
+    /**
+     * @brief Release the memory a worker took for the previous chunk
+     * @param _state The state of the worker
+     *
+     * Empties the worker Arena and builds its Expression again on it, so
+     * the Arena blocks are reused by each chunk instead of growing
+     */
+    void recycle(State &_state);
+
+    /**
+     * @brief Evaluate a line, looking for it on the cache first
+     * @param _expr The line expression
+     * @param _return Keep the line Result
+     * @param _state The state of the worker evaluating the line
+     */
+    void calculate(std::string_view _expr, Result &_return, State &_state);
+
+    /**
+     * @brief Evaluate all lines of a chunk
+     * @param _chunk The chunk
+     * @param _state The state of the worker evaluating the chunk
+     */
+    void evaluate(Chunk &_chunk, State &_state);
+
+    /**
+     * @brief Evaluate all lines of a chunk as a single batch
+     * @param _chunk The chunk
+     * @param _state The state of the worker evaluating the chunk
+     */
+    void evaluate_batch(Chunk &_chunk, State &_state);
+
+    unsigned m_threads;              //!< The number of threads
+    ResultCache *m_cache;            //!< The cache of results (or null)
+    bool m_share;                    //!< Flag to share subexpressions
+    Profiler *m_profiler;            //!< The Profiler of each phase (or null)
+    std::vector<State> m_states;     //!< The workers states
+    std::vector<std::size_t> m_lengths;  //!< The lines copied by read
+    std::mutex m_mutex;              //!< The chunks done flag mutex
+    std::condition_variable m_done;  //!< Notifies an evaluated chunk
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*!
+ *  @file editable_expression.hpp
+ *  @brief Editable Expression Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Editable Expression Class header
+ */
+
+#ifndef _editable_expression_hpp_
+#define _editable_expression_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "expression.hpp"
+#include "lexer.hpp"
+#include "result.hpp"
+
+/**
+ * @brief Editable Expression Class
+ *
+ * An expression changed by small edits (e.g. on an editor, after each key),
+ * whose Result is the same of an Expression with the current text, but is
+ * updated by the size of each edit instead of the size of the text.
+ *
+ * The tokens are kept on a balanced tree, each one with the syntax error the
+ * Lexer finds on it, so an edit only reads again the tokens around it (until
+ * the Lexer state is the same as before), and the first error of the text,
+ * its unbalanced parentheses and their columns are found on the tree.
+ *
+ * A valid text is also kept as a tree of parenthesized groups, each one a
+ * sum of terms (on another balanced tree, with the sums and the first
+ * error) and each term a product of powers. The terms edited are read
+ * again, and only the groups around them are evaluated again, each one by
+ * the size of its edited term. The juxtapositions accepted by the Lexer
+ * (e.g. "2 (3)", "(* 3)" or "- - 3") are evaluated by an Expression.
+ *
+ * 16-bit only, as the Programs (see Expression::compile).
+ */
+class EditableExpression {
+ public:
+    /**
+     * @brief Editable Expression Constructor
+     * @param _expr The initial text (default = "")
+     */
+    explicit EditableExpression(std::string_view _expr = "");
+
+    /**
+     * @brief Editable Expression Destructor
+     *
+     * Release the tokens and the groups
+     */
+    ~EditableExpression();
+
+    EditableExpression(const EditableExpression &) = delete;
+    EditableExpression &operator=(const EditableExpression &) = delete;
+
+    /**
+     * @brief Replace the whole text
+     * @param _expr The new text
+     */
+    void reset(std::string_view _expr);
+
+    /**
+     * @brief Edit the text
+     * @param _offset The position of the edit
+     * @param _removed The number of characters removed from the position
+     * @param _inserted The characters inserted on the position
+     *
+     * @return True if all succeed, False if the range is out of the text
+     */
+    bool edit(std::size_t _offset, std::size_t _removed,
+              std::string_view _inserted);
+
+    /**
+     * @brief Get the text
+     * @return The current text
+     */
+    const std::string &text() const { return m_text; }
+
+    /**
+     * @brief Calculate the Result of the current text
+     * @param _return The Result (value or error), the same of an Expression
+     *
+     * @return True if all succeed, False if not
+     */
+    bool calculate(Result &_return);
+
+ private:
+    typedef BasicArithmetic<Int16> Arithmetic;  //!< The operations
+
+    /**
+     * @brief The Lexer state after a token
+     */
+    struct State {
+        LexerTable::State state = LexerTable::AFTER_NOTHING;  //!< The state
+        bool unary = false;  //!< Flag to indicate a unary minus
+    };
+
+    struct Token;
+    struct TokenNode;
+    struct Item;
+    struct Term;
+    struct TermNode;
+    struct Group;
+
+    /**
+     * @brief Read a token
+     * @param _pos The position of its first character
+     * @param _spaces The number of whitespaces before it
+     * @param _state The Lexer state after the token before it
+     * @param _return Keep the token
+     */
+    void read_token(std::size_t _pos, std::size_t _spaces,
+                    const State &_state, Token &_return) const;
+
+    /**
+     * @brief Find the first syntax error of the text
+     * @param _return Keep the error (if any)
+     *
+     * @return True if there is no error, False otherwise
+     */
+    bool find_error(Result &_return) const;
+
+    /**
+     * @brief Mark the tokens changed since the groups were updated
+     * @param _begin The index of the first token replaced
+     * @param _end The index after the last token replaced (before the edit)
+     * @param _size The number of tokens inserted
+     */
+    void touch(unsigned _begin, unsigned _end, unsigned _size);
+
+    /**
+     * @brief Update the groups to the current tokens
+     *
+     * Reads again the terms with a changed token (or with the tokens next
+     * to them) on the innermost group around them, or on its parent when
+     * they don't fit on it anymore
+     */
+    void update();
+
+    /**
+     * @brief Read a sequence of terms
+     * @param _tokens The tokens (balanced)
+     * @param _signed Flag to indicate the first token is a binary operator
+     * @param _group The group of the terms
+     * @param _return Keep the terms
+     *
+     * @return True if all succeed, False if the tokens aren't a sequence of
+     * terms (and nothing is kept)
+     */
+    bool parse(const std::vector<Token> &_tokens, bool _signed, Group *_group,
+               std::vector<TermNode *> &_return);
+
+    /**
+     * @brief Evaluate a group again, and all groups around it
+     * @param _group The group whose terms were changed
+     */
+    void settle(Group *_group);
+
+    /**
+     * @brief Get a random priority for a tree node
+     * @return The priority
+     */
+    std::uint32_t priority();
+
+    std::string m_text;             //!< The text
+    TokenNode *m_tokens = nullptr;  //!< The tokens tree
+    Group *m_root = nullptr;        //!< The whole text group (or null)
+    bool m_dirty = false;     //!< Flag to indicate the tokens were changed
+    unsigned m_dirty_begin = 0;  //!< The first token changed
+    unsigned m_dirty_end = 0;    //!< The token after the last one changed
+    long m_dirty_delta = 0;      //!< The number of tokens inserted (net)
+    std::uint32_t m_seed = 0x9e3779b9;  //!< The priorities generator state
+    //! The Expression of the texts that aren't on the groups
+    Expression m_expr{std::string_view()};
+};
+
+#endif
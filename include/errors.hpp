@@ -10,6 +10,7 @@
 #define _errors_hpp_
 
 #include <string>
+#include <string_view>
 #include "queue.hpp"
 #include "term.hpp"
 
@@ -45,16 +46,50 @@ class Errors {
         std::string _return = "";
         if (_id > 8)
             return _return;
+        _return = get_error_prefix(_id);
+        if (has_column(_id)) {
+            _return += std::to_string(_col + 1);
+            _return += get_error_suffix(_id);
+        }
+        return _return;
+    }
+
+    /**
+     * @brief Verify if an error is reported with its column
+     * @param _id  Error ID
+     *
+     * @return True if the error has a column, False otherwise
+     */
+    static bool has_column(unsigned _id) {
+        return _id <= 6;
+    }
+
+    /**
+     * @brief Gets the (precomputed) error message before the column
+     * @param _id  Error ID (must be valid)
+     *
+     * @return The message prefix (the whole message if it has no column)
+     */
+    static std::string_view get_error_prefix(unsigned _id) {
 #if(_FULL_ERROR_MESSAGES_)
-        _return = m_errors[_id];
-        if (_id <= 6)
-            _return += std::to_string(_col + 1) + ".";
+        return m_errors[_id];
 #else
-        _return = "E" + std::to_string(_id + 1);
-        if (_id <= 6)
-            _return += " " + std::to_string(_col + 1);
+        return m_error_ids[_id];
+#endif
+    }
+
+    /**
+     * @brief Gets the error message after the column
+     * @param _id  Error ID (must be valid)
+     *
+     * @return The message suffix
+     */
+    static std::string_view get_error_suffix(unsigned _id) {
+#if(_FULL_ERROR_MESSAGES_)
+        return has_column(_id) ? "." : "";
+#else
+        return "";
 #endif
-        return _return;
     }
 
  private:
@@ -62,6 +97,11 @@ class Errors {
      * @brief A vector of Errors Messages
      */
     static std::string m_errors[9];
+
+    /**
+     * @brief A vector of Errors IDs (as shown without the full messages)
+     */
+    static std::string m_error_ids[9];
 };
 
 #endif
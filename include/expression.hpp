@@ -9,41 +9,228 @@
 #ifndef _expression_hpp_
 #define _expression_hpp_
 
+#include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "arithmetic.hpp"
+#include "lexer.hpp"
+#include "numeric.hpp"
+#include "profiler.hpp"
+#include "program.hpp"
 #include "queue.hpp"
+#include "result.hpp"
+#include "shunting_yard.hpp"
+#include "stack.hpp"
 #include "term.hpp"
 
 /**
  * @brief Expression Class
  *
- * The Expression implementation.
+ * The Expression implementation, on the numbers of a Policy (see
+ * numeric.hpp). Each Policy is a separate instantiation, so the range
+ * checks of each one are resolved at compile time.
+ *
+ * @see Expression (the default, 16-bit, evaluator)
  */
-class Expression {
+template <typename Policy>
+class BasicExpression {
  public:
+    typedef typename Policy::value_type value_type;  //!< The numbers type
+    typedef BasicTerm<value_type> Term;              //!< The Term type
+    typedef BasicResult<value_type> Result;          //!< The Result type
+    typedef BasicArithmetic<Policy> Arithmetic;      //!< The operations
+
+    /**
+     * @brief The evaluation modes
+     */
+    enum Mode {
+        PHASED,  //!< Tokenize, convert to postfix and evaluate in three passes
+        FUSED    //!< Do all the phases in a single pass over the expression
+    };
+
+    /**
+     * @brief Expression Constructor
+     * @param _expr Receives the initial Expression content
+     *
+     * Creates a Expression with a copy of a string (default = "")
+     */
+    explicit BasicExpression(std::string _expr = "");
+
     /**
      * @brief Expression Constructor
      * @param _expr Receives the initial Expression content
      *
-     * Creates a Expression with a string (default = "")
+     * Creates a Expression with a copy of a C string
      */
-    explicit Expression(std::string _expr = "");
+    explicit BasicExpression(const char *_expr);
+
+    /**
+     * @brief Expression Constructor
+     * @param _expr Receives the initial Expression content
+     * @param _resource The memory for the terms Stacks and Queues (e.g. an
+     * Arena reused across expressions by a thread)
+     *
+     * Creates a Expression without copying the text, which must outlive it
+     */
+    explicit BasicExpression(std::string_view _expr,
+                        std::pmr::memory_resource *_resource =
+                            std::pmr::get_default_resource());
+
+    BasicExpression(const BasicExpression &) = delete;
+    BasicExpression &operator=(const BasicExpression &) = delete;
 
     /**
      * @brief Expression Destructor
      *
-     * Delete expression and empty all Queues
+     * Release the Queues buffers
+     */
+    ~BasicExpression();
+
+    /**
+     * @brief Replace the Expression content
+     * @param _expr The new Expression content (must outlive the evaluation)
+     *
+     * Clears the error and the terms of the previous content, keeping the
+     * Stacks and Queues buffers, so an Expression reused for many lines
+     * doesn't allocate once its buffers are big enough
      */
-    ~Expression();
+    void reset(std::string_view _expr);
+
+    /**
+     * @brief Calculate the Expression Result
+     * @param _return The Expression Result (value or error)
+     * @param _mode The evaluation mode (default = FUSED)
+     *
+     * @return True if al succeed, False if not
+     */
+    bool calculate(Result &_return, Mode _mode = FUSED);
 
     /**
      * @brief Calculate the Expression Result
      * @param _return The Expression result or error message
+     * @param _mode The evaluation mode (default = FUSED)
      *
      * @return True if al succeed, False if not
      */
-    bool calculate(std::string &_return);
+    bool calculate(std::string &_return, Mode _mode = FUSED);
+
+    /**
+     * @brief Calculate the Expression Result, measuring each phase
+     * @param _return The Expression Result (value or error)
+     * @param _profiler The Profiler of the tokenize, infix2postfix and
+     * get_result phases
+     *
+     * Same as the PHASED mode, with the Profiler started and stopped around
+     * each phase (the phases not reached after an error aren't measured).
+     *
+     * @return True if al succeed, False if not
+     */
+    bool calculate(Result &_return, Profiler &_profiler);
+
+    /**
+     * @brief Compile the Expression to a Program
+     * @param _return The compiled Program
+     * @see Program::eval
+     *
+     * When the Expression is invalid, the Program keeps the error, so its
+     * evaluation always gives the same result as calculate. Programs are
+     * 16-bit, so it's only available on the default Expression (on other
+     * policies, calling it doesn't compile).
+     *
+     * @return True if al succeed, False if not
+     */
+    template <typename P = Policy>
+    bool compile(Program &_return);
+
+    /**
+     * @brief Compile the Expression with variables to a Program
+     * @param _return The compiled Program
+     * @param _variables The variable names (the index is the variable id)
+     * @see Program::eval_batch
+     *
+     * A variable name starts with a letter or '_', followed by letters,
+     * digits or '_', and is read as a number. Names that weren't declared
+     * are invalid operands, as any other unknown symbol. Only available on
+     * the default Expression, as compile.
+     *
+     * @return True if al succeed, False if not
+     */
+    template <typename P = Policy>
+    bool compile(Program &_return, const std::vector<std::string> &_variables);
+
+    /**
+     * @brief Calculate the Results of a batch of expressions
+     * @param _exprs The expressions
+     * @param _return The Results, in the same order of the expressions
+     * @param _resource The memory for the batch terms and subexpressions
+     * (e.g. an Arena reset after each batch)
+     *
+     * Equal subexpressions (e.g. the same parenthesized expression on many
+     * lines) are evaluated only once by batch. The Results are the same of
+     * calculate, with the error columns relative to each expression.
+     */
+    static void calculate_batch(const std::vector<std::string_view> &_exprs,
+                                std::vector<Result> &_return,
+                                std::pmr::memory_resource *_resource =
+                                    std::pmr::get_default_resource());
+
+    /**
+     * @brief Count the leading zeros of a valid expression value
+     * @param _expr The expression
+     * @return The leading zeros of its last constant when the expression
+     * has only constants and parentheses (e.g. 2 on "(007)"), 0 otherwise
+     *
+     * Without operators, the value is the last constant as it was written,
+     * so it's printed with its leading zeros (as the original string terms).
+     */
+    static int leading_zeros(std::string_view _expr);
 
  private:
+    typedef BasicLexer<Policy> Lexer;  //!< The Lexer type
+    //! The allocator of the terms Stacks and Queues
+    typedef std::pmr::polymorphic_allocator<Term> TermAllocator;
+    //! The Stack used for operators and operands, which keeps the terms of
+    //! the usual nesting depth inline (without allocating)
+    typedef Stack<Term, 16, TermAllocator> TermStack;
+    //! The Queue used for infix and postfix terms
+    typedef Queue<Term, TermAllocator> TermQueue;
+    typedef BasicShuntingYard<Policy> ShuntingYard;  //!< The shared core
+
+    /**
+     * @brief Compile the Expression with variables to a Program
+     * @param _return The compiled Program
+     * @param _variables The variable names (the index is the variable id)
+     * @see compile
+     *
+     * Defined only for the default Expression
+     *
+     * @return True if al succeed, False if not
+     */
+    bool compile_program(Program &_return,
+                         const std::vector<std::string> &_variables);
+
+    /**
+     * @brief Read all Expression tokens
+     * @param _sink The function called with each token, in infix order
+     *
+     * @return True if everything is ok, False if not
+     */
+    template <typename Sink>
+    bool lex(Sink &&_sink);
+
+    /**
+     * @brief Find a declared variable name starting on a column
+     * @param _begin The column where the name starts
+     * @param _end The var to keep the column after the name
+     * @param _index The var to keep the variable id
+     *
+     * @return True if a declared variable was found, False otherwise
+     */
+    bool find_variable(unsigned _begin, unsigned &_end, int &_index) const;
+
     /**
      * @brief Create a queue with all Expression tokens
      *
@@ -52,124 +239,181 @@ class Expression {
     bool tokenize();
 
     /**
-     * @brief Convert an infix expression to postfix
+     * @brief Send one infix term through the operators Stack
+     * @param _t The infix term
+     * @param _operators The operators Stack
+     * @param _sink The function called with each term, in postfix order
+     * @see ShuntingYard::shunt
      *
      * @return True if all succeed, False otherwise
      */
-    bool infix2postfix();
+    template <typename Sink>
+    bool shunt(const Term &_t, TermStack &_operators, Sink &&_sink);
 
     /**
-     * @brief Apply the operator function on two terms
-     * @param _t1 The first term of operation
-     * @param _t2 The second term of operation
-     * @param _op The operator
-     * @param _rst The Term where the value will be returned
+     * @brief Flush the operators Stack after the last infix term
+     * @param _operators The operators Stack
+     * @param _sink The function called with each term, in postfix order
+     * @see ShuntingYard::shunt_end
      *
      * @return True if all succeed, False otherwise
      */
-    bool apply_operation(Term _t1, Term _t2, Term _op, Term &_rst);
+    template <typename Sink>
+    bool shunt_end(TermStack &_operators, Sink &&_sink);
 
     /**
-     * @brief Get the expression result from a postfix queue
-     * @param _return The Term with the final expression result
+     * @brief Convert an infix expression to postfix
      *
      * @return True if all succeed, False otherwise
      */
-    bool get_result(Term &_return);
+    bool infix2postfix();
 
     /**
-     * @brief Function to set error
-     * @param _id The error id
-     * @param _col The error col
+     * @brief The operands used on an evaluation
      *
-     * Sets the error
+     * Keeps the operands Stack and the last operands taken from it, which
+     * are reused when an operator finds the Stack empty (e.g. on "2%(+3)")
      */
-    void set_error(const int _id = -1, const int _col = -1);
+    struct Operands {
+        /**
+         * @brief Operands Constructor
+         * @param _allocator The operands Stack allocator
+         */
+        explicit Operands(const TermAllocator &_allocator)
+            : stack(1, _allocator) {}
+
+        TermStack stack;    //!< The operands Stack
+        Term lhs;           //!< The last left hand side operand
+        Term rhs;           //!< The last right hand side operand (or result)
+    };
 
     /**
-     * @brief Gets the operand precedence
-     * @param _t The term to be used on function
-     * @return A integer with the operand precedence
-     * @see is_operand
-     *
-     * Gets the operand precedence using that table:
-     *
-     * |  Operator  |  Precedence  |
-     * |  :------:  |  :--------:  |
-     * |  ( )       |  1           |
-     * |  - (unary) |  2           |
-     * |  ^         |  3           |
-     * |  / * %     |  4           |
-     * |  + -       |  5           |
+     * @brief Empty the operators and operands Stacks, keeping their buffers
      */
-    int get_precedence(Term _t) const;
+    void reset_stacks();
 
     /**
-     * @brief Gets the integer value from a Term
-     * @param _t The term to be used on function
-     * @param _return The var to keep the returned value
+     * @brief Apply one postfix term to the operands
+     * @param _t The postfix term
+     * @param _operands The operands
+     * @see ShuntingYard::reduce
+     *
      * @return True if all succeed, False otherwise
+     */
+    bool reduce(const Term &_t, Operands &_operands);
+
+    /**
+     * @brief The subexpressions shared by a batch
+     */
+    struct Subexpressions;
+
+    /**
+     * @brief Add the Expression terms to the batch subexpressions
+     * @param _shared The batch subexpressions
+     * @param _roots Keep the subexpressions left on the operands Stack
+     * @param _balanced Keep if every operator found its operands
      *
-     * Gets the Term integer value
+     * When an operator finds the operands Stack empty, its result depends on
+     * the operands taken before (see Operands), so it can't be shared.
+     *
+     * @return True if all succeed, False otherwise
      */
-    bool get_int_number(Term _t, int &_return) const;
+    bool share(Subexpressions &_shared, std::pmr::vector<unsigned> &_roots,
+               bool &_balanced);
 
     /**
-     * @brief Verify if the term value is a number
-     * @param _t The term to be used on function
-     * @return True if is a number, False otherwise
+     * @brief Get the expression result from a postfix queue
+     * @param _return The Term with the final expression result
      *
-     * Verify if is a number
+     * @return True if all succeed, False otherwise
      */
-    bool is_number(Term _t) const;
+    bool get_result(Term &_return);
 
     /**
-     * @brief Verify if the term value is a valid number
-     * @param _t The term to be used on function
-     * @return True if is valid, False otherwise
-     * @see is_number
+     * @brief Get the expression result in a single pass
+     * @param _return The Term with the final expression result
+     *
+     * Tokenize, convert to postfix and evaluate the expression at the same
+     * time, without the intermediate queues.
      *
-     * Verify if is a valid number (in range [-32.768, 32.767])
+     * @return True if all succeed, False otherwise
      */
-    bool is_valid_number(Term _t) const;
+    bool evaluate(Term &_return);
 
     /**
-     * @brief Verify if the Term is an expression operator
-     * @param _t The term to be used on function
-     * @return True if is an operator, False otherwise
+     * @brief Function to set error
+     * @param _id The error id
+     * @param _col The error col
      *
-     * Verify if is a operator (+, -, /, *, ^, %)
+     * Sets the error
      */
-    bool is_operator(Term _t) const;
+    void set_error(const int _id = -1, const int _col = -1);
 
     /**
-     * @brief Verify if the Term is a opening parenthesis
+     * @brief Verify if the term value is a number
      * @param _t The term to be used on function
-     * @return True if is an opening parenthesis, False if not
-     * @see is_closing_parenthesis
+     * @return True if is a number, False otherwise
      *
-     * Verify if is a opening parenthesis
+     * Verify if is a number
      */
-    bool is_opening_parenthesis(Term _t) const;
+    bool is_number(const Term &_t) const;
 
     /**
-     * @brief Verify if the Term is an closing parenthesis
+     * @brief Verify if the Term is a variable
      * @param _t The term to be used on function
-     * @return True if is a closing parenthesis, False if not
-     * @see is_opening_parenthesis
+     * @return True if is a variable, False otherwise
      *
-     * Verify if is a closing parenthesis
+     * Verify if is a variable
      */
-    bool is_closing_parenthesis(Term _t) const;
+    bool is_variable(const Term &_t) const;
 
     //! The error structure
     struct {
         int id = -1;   //!< The error code
         int col = -1;  //!< The error code
     } m_error;
-    std::string m_expr = "";      //!< A expression string
-    Queue<Term> *m_terms;         //!< A pointer to a expression terms Queue
-    Queue<Term> *m_terms_postfix;  //!< A pointer to a postfix expression Queue
+    std::string m_text = "";      //!< The expression string (if copied)
+    std::string_view m_expr;      //!< A expression string
+    //! The variable names declared while compiling
+    const std::vector<std::string> *m_variables = nullptr;
+    TermAllocator m_allocator;    //!< The terms Stacks and Queues allocator
+    //! The terms begin of a long line (see Kernels::scan)
+    std::pmr::vector<std::uint64_t> m_starts{m_allocator};
+    //! The expression terms Queue (only allocated by the phased mode)
+    TermQueue m_terms{0, m_allocator};
+    //! The postfix expression Queue (only allocated by the phased mode)
+    TermQueue m_terms_postfix{0, m_allocator};
+    TermStack m_operators{1, m_allocator};  //!< The operators Stack
+    Operands m_operands{m_allocator};       //!< The operands
 };
 
+//! The default evaluator, on the original 16-bit range
+typedef BasicExpression<Int16> Expression;
+
+// Programs are 16-bit, so only the default Expression compiles them (a
+// member template, so the other policies instantiated below don't fail)
+template <typename Policy>
+template <typename P>
+bool BasicExpression<Policy>::compile(Program &_return) {
+    return compile<P>(_return, std::vector<std::string>());
+}
+
+template <typename Policy>
+template <typename P>
+bool BasicExpression<Policy>::compile(
+    Program &_return, const std::vector<std::string> &_variables) {
+    static_assert(std::is_same_v<P, Int16>,
+                  "Programs are 16-bit, only an Expression compiles them");
+    return compile_program(_return, _variables);
+}
+
+template <>
+bool BasicExpression<Int16>::compile_program(
+    Program &_return, const std::vector<std::string> &_variables);
+
+// The policies instantiated on expression.cpp
+extern template class BasicExpression<Int16>;
+extern template class BasicExpression<Int32>;
+extern template class BasicExpression<Int64>;
+
 #endif
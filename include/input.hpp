@@ -0,0 +1,112 @@
+/*!
+ *  @file input.hpp
+ *  @brief Input Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Input Class header
+ */
+
+#ifndef _input_hpp_
+#define _input_hpp_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Input Class
+ *
+ * Splits an input in lines without copying them. A regular file is mapped
+ * on memory and its lines are views of the mapping; anything else (e.g. a
+ * pipe) is read in blocks to a buffer, reused across lines.
+ */
+class Input {
+ public:
+    /**
+     * @brief Input Constructor
+     * @param _path The file path
+     *
+     * Opens a file, mapping it on memory when possible
+     */
+    explicit Input(const std::string &_path);
+
+    /**
+     * @brief Input Constructor
+     * @param _fd An opened file descriptor (e.g. 0 for the standard input)
+     *
+     * Reads from a file descriptor, which isn't closed on destruction
+     */
+    explicit Input(int _fd);
+
+    /**
+     * @brief Input Constructor
+     * @param _data The input content (must outlive the Input)
+     * @param _size The input content size
+     *
+     * Reads from a memory buffer
+     */
+    Input(const char *_data, std::size_t _size);
+
+    /**
+     * @brief Input Destructor
+     *
+     * Unmap and close the file (if it was opened here)
+     */
+    ~Input();
+
+    Input(const Input &) = delete;
+    Input &operator=(const Input &) = delete;
+
+    /**
+     * @brief Verify if the Input was opened
+     * @return True if is open, False otherwise
+     */
+    bool is_open() const;
+
+    /**
+     * @brief Verify if all reads succeeded
+     * @return True if is open and no read failed, False otherwise (the
+     * lines stop at the failure, so the input was read only in part)
+     */
+    bool good() const;
+
+    /**
+     * @brief Verify if the lines are valid until the Input is destroyed
+     * @return True if the lines are views of the whole input (mapped or on
+     * memory), False if they're only valid until the next line is read
+     */
+    bool is_stable() const;
+
+    /**
+     * @brief Gets the next line
+     * @param _return Keep the line (without the line break)
+     * @return True if a line was read, False at the end of input (or on a
+     * read failure, see good)
+     */
+    bool next(std::string_view &_return);
+
+ private:
+    /**
+     * @brief Read the next block from the file to the buffer
+     * @return True if something was read, False at the end of file (or on
+     * a read failure)
+     */
+    bool fill();
+
+    int m_fd = -1;                  //!< The file descriptor
+    bool m_owns_fd = false;         //!< Flag to indicate if closes the file
+    bool m_open = false;            //!< Flag to indicate if it was opened
+    bool m_failed = false;          //!< Flag to indicate if a read failed
+    bool m_mapped = false;          //!< Flag to indicate if it's mapped
+    bool m_stream = false;          //!< Flag to indicate if reads in blocks
+    const char *m_data = nullptr;   //!< The input content
+    std::size_t m_size = 0;         //!< The input content size
+    std::size_t m_pos = 0;          //!< The next line position
+    //! The position where the search for the line break resumes (the
+    //! characters before it, since m_pos, have no line break)
+    std::size_t m_scan = 0;
+    std::vector<char> m_buffer;     //!< The buffer used by streaming reads
+};
+
+#endif
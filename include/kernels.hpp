@@ -0,0 +1,99 @@
+/*!
+ *  @file kernels.hpp
+ *  @brief Kernels Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Kernels Class header
+ */
+
+#ifndef _kernels_hpp_
+#define _kernels_hpp_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Kernels Class
+ *
+ * The vectorized operations used to evaluate a Program over many rows at
+ * once, and to scan long expressions (don't need to be instanciated). The
+ * instruction set is chosen on the first use (AVX2, SSE4.1 or a scalar
+ * fallback).
+ */
+class Kernels {
+ public:
+    /**
+     * @brief The supported instruction sets
+     */
+    enum Isa {
+        SCALAR,  //!< Plain C++ loops
+        SSE,     //!< SSE4.1 (4 rows per instruction)
+        AVX2     //!< AVX2 (8 rows per instruction)
+    };
+
+    /**
+     * @brief Kernels Constructor
+     *
+     * Delete Constructor
+     */
+    Kernels() = delete;
+
+    /**
+     * @brief Kernels Destructor
+     *
+     * Delete Destructor
+     */
+    ~Kernels() = delete;
+
+    /**
+     * @brief Gets the instruction set in use
+     * @return The instruction set
+     */
+    static Isa isa();
+
+    /**
+     * @brief Verify if the CPU supports an instruction set
+     * @param _isa The instruction set
+     * @return True if is supported, False otherwise
+     */
+    static bool is_supported(Isa _isa);
+
+    /**
+     * @brief Choose the instruction set to be used
+     * @param _isa The instruction set
+     * @return True if it was selected, False if isn't supported
+     */
+    static bool select(Isa _isa);
+
+    /**
+     * @brief Apply an operator on two arrays of values
+     * @param _op The operator symbol (+, -, /, *, ^, %)
+     * @param _v1 The first values of operation
+     * @param _v2 The second values of operation
+     * @param _rst The array to keep the results (can be _v1 or _v2)
+     * @param _errors The error id of each row (-1 if there is no error)
+     * @param _size The number of rows
+     *
+     * Same as Arithmetic::apply on each row. A row keeps its first error,
+     * and its result is undefined after that.
+     */
+    static void apply(int _op, const int *_v1, const int *_v2, int *_rst,
+                      int *_errors, unsigned _size);
+
+    /**
+     * @brief Find where the terms of an expression begin
+     * @param _text The expression text
+     * @param _size The expression size
+     * @param _starts The bitmap to keep the terms begin, one bit by
+     * character (with (_size + 63) / 64 words)
+     * @return The position of the first character that can't be on an
+     * expression, even as a variable name (_size if there isn't one)
+     *
+     * A term begins on each character except whitespaces and the digits
+     * after the first one of a number (see BasicLexer::lex).
+     */
+    static std::size_t scan(const char *_text, std::size_t _size,
+                            std::uint64_t *_starts);
+};
+
+#endif
@@ -0,0 +1,324 @@
+/*!
+ *  @file lexer.hpp
+ *  @brief Lexer Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Lexer Class header
+ */
+
+#ifndef _lexer_hpp_
+#define _lexer_hpp_
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "arithmetic.hpp"
+#include "numeric.hpp"
+#include "term.hpp"
+
+/**
+ * @brief Lexer Table Class
+ *
+ * The Lexer automaton (don't need to be instanciated): each character has a
+ * class (see classes), and the pair (state, class) gives the next state, the
+ * action on the character and the syntax error, if there is one (see
+ * transitions). Only the rules that count (the numbers range, the
+ * parentheses and the last operator) are out of the table.
+ */
+class LexerTable {
+ public:
+    /**
+     * @brief Lexer Table Constructor
+     *
+     * Delete Constructor
+     */
+    LexerTable() = delete;
+
+    /**
+     * @brief Lexer Table Destructor
+     *
+     * Delete Destructor
+     */
+    ~LexerTable() = delete;
+
+    /**
+     * @brief The states (what was the last character)
+     */
+    enum State : unsigned char {
+        AFTER_NOTHING,        //!< The line begin
+        AFTER_NOTHING_SPACE,  //!< Whitespaces on the line begin
+        AFTER_NUMBER,         //!< A number or a variable
+        AFTER_NUMBER_SPACE,   //!< A number or a variable and whitespaces
+        AFTER_OPERATOR,       //!< An operator (and whitespaces)
+        AFTER_OPENING,        //!< An opening parenthesis
+        AFTER_OPENING_SPACE,  //!< An opening parenthesis and whitespaces
+        AFTER_CLOSING,        //!< A closing parenthesis (and whitespaces)
+        STATES                //!< The number of states
+    };
+
+    /**
+     * @brief The characters classes
+     */
+    enum Class : unsigned char {
+        SPACE,     //!< A whitespace
+        DIGIT,     //!< A digit
+        SYMBOL,    //!< An operator symbol (except '-')
+        MINUS,     //!< The '-' symbol (unary or binary)
+        OPENING,   //!< An opening parenthesis
+        CLOSING,   //!< A closing parenthesis
+        VARIABLE,  //!< Any other character (a declared variable)
+        INVALID,   //!< Any other character, without a variable declared
+        END,       //!< The line end
+        CLASSES    //!< The number of classes
+    };
+
+    /**
+     * @brief The actions on a character
+     */
+    enum Action : unsigned char {
+        SKIP,             //!< Nothing to do
+        NEW_NUMBER,       //!< Begin a number
+        NEXT_DIGIT,       //!< Add a digit to the number
+        BINARY_OPERATOR,  //!< Send a binary operator
+        UNARY_OPERATOR,   //!< Send a unary operator
+        OPEN_GROUP,       //!< Send an opening parenthesis
+        CLOSE_GROUP,      //!< Send a closing parenthesis
+        READ_VARIABLE     //!< Read a variable name
+    };
+
+    /**
+     * @brief The transition struct
+     */
+    struct Transition {
+        State next;         //!< The next state
+        Action action;      //!< The action on the character
+        bool emit;          //!< Flag to send the number read before
+        signed char error;  //!< The error id (-1 if there is no error)
+    };
+
+    //! The class of each character
+    static constexpr std::array<Class, 256> classes = [] {
+        std::array<Class, 256> _classes{};
+        for (auto &_class : _classes)
+            _class = VARIABLE;
+        for (auto c('0'); c <= '9'; c++)
+            _classes[c] = DIGIT;
+        for (auto c : {'%', '*', '+', '/', '^'})
+            _classes[c] = SYMBOL;
+        _classes[' '] = SPACE;
+        _classes['-'] = MINUS;
+        _classes['('] = OPENING;
+        _classes[')'] = CLOSING;
+        return _classes;
+    }();
+
+    //! The transition of each state by each class (the error ids are the
+    //! same of Errors: 1 is E2, 2 is E3, 3 is E4 and 5 is E6)
+    static constexpr Transition transitions[STATES][CLASSES] = {
+        // AFTER_NOTHING
+        {{AFTER_NOTHING_SPACE, SKIP, false, -1},
+         {AFTER_NUMBER, NEW_NUMBER, false, -1},
+         {AFTER_OPERATOR, SKIP, false, 5},
+         {AFTER_OPERATOR, UNARY_OPERATOR, false, -1},
+         {AFTER_OPENING, OPEN_GROUP, false, -1},
+         {AFTER_CLOSING, CLOSE_GROUP, false, -1},
+         {AFTER_NUMBER, READ_VARIABLE, false, -1},
+         {AFTER_NOTHING, SKIP, false, 2},
+         {AFTER_NOTHING, SKIP, false, -1}},
+        // AFTER_NOTHING_SPACE
+        {{AFTER_NOTHING_SPACE, SKIP, false, -1},
+         {AFTER_NUMBER, NEW_NUMBER, false, -1},
+         {AFTER_OPERATOR, SKIP, false, 5},
+         {AFTER_OPERATOR, UNARY_OPERATOR, false, -1},
+         {AFTER_OPENING, OPEN_GROUP, false, -1},
+         {AFTER_CLOSING, CLOSE_GROUP, false, -1},
+         {AFTER_NUMBER, READ_VARIABLE, false, -1},
+         {AFTER_NOTHING, SKIP, false, 2},
+         {AFTER_NOTHING, SKIP, false, 1}},
+        // AFTER_NUMBER
+        {{AFTER_NUMBER_SPACE, SKIP, false, -1},
+         {AFTER_NUMBER, NEXT_DIGIT, false, -1},
+         {AFTER_OPERATOR, BINARY_OPERATOR, true, -1},
+         {AFTER_OPERATOR, BINARY_OPERATOR, true, -1},
+         {AFTER_OPENING, OPEN_GROUP, true, -1},
+         {AFTER_CLOSING, CLOSE_GROUP, true, -1},
+         {AFTER_NUMBER, SKIP, false, 3},
+         {AFTER_NUMBER, SKIP, false, 2},
+         {AFTER_NUMBER, SKIP, true, -1}},
+        // AFTER_NUMBER_SPACE
+        {{AFTER_NUMBER_SPACE, SKIP, false, -1},
+         {AFTER_NUMBER, SKIP, false, 3},
+         {AFTER_OPERATOR, BINARY_OPERATOR, true, -1},
+         {AFTER_OPERATOR, BINARY_OPERATOR, true, -1},
+         {AFTER_OPENING, OPEN_GROUP, true, -1},
+         {AFTER_CLOSING, CLOSE_GROUP, true, -1},
+         {AFTER_NUMBER, SKIP, false, 3},
+         {AFTER_NUMBER, SKIP, false, 2},
+         {AFTER_NUMBER, SKIP, true, -1}},
+        // AFTER_OPERATOR
+        {{AFTER_OPERATOR, SKIP, false, -1},
+         {AFTER_NUMBER, NEW_NUMBER, false, -1},
+         {AFTER_OPERATOR, SKIP, false, 5},
+         {AFTER_OPERATOR, UNARY_OPERATOR, false, -1},
+         {AFTER_OPENING, OPEN_GROUP, false, -1},
+         {AFTER_CLOSING, SKIP, false, 1},
+         {AFTER_NUMBER, READ_VARIABLE, false, -1},
+         {AFTER_OPERATOR, SKIP, false, 1},
+         {AFTER_OPERATOR, SKIP, false, 1}},
+        // AFTER_OPENING
+        {{AFTER_OPENING_SPACE, SKIP, false, -1},
+         {AFTER_NUMBER, NEW_NUMBER, false, -1},
+         {AFTER_OPERATOR, BINARY_OPERATOR, false, -1},
+         {AFTER_OPERATOR, UNARY_OPERATOR, false, -1},
+         {AFTER_OPENING, OPEN_GROUP, false, -1},
+         {AFTER_CLOSING, SKIP, false, 1},
+         {AFTER_NUMBER, READ_VARIABLE, false, -1},
+         {AFTER_OPENING, SKIP, false, 2},
+         {AFTER_OPENING, SKIP, false, -1}},
+        // AFTER_OPENING_SPACE
+        {{AFTER_OPENING_SPACE, SKIP, false, -1},
+         {AFTER_NUMBER, NEW_NUMBER, false, -1},
+         {AFTER_OPERATOR, BINARY_OPERATOR, false, -1},
+         {AFTER_OPERATOR, UNARY_OPERATOR, false, -1},
+         {AFTER_OPENING, OPEN_GROUP, false, -1},
+         {AFTER_CLOSING, SKIP, false, 1},
+         {AFTER_NUMBER, READ_VARIABLE, false, -1},
+         {AFTER_OPENING, SKIP, false, 2},
+         {AFTER_OPENING, SKIP, false, 1}},
+        // AFTER_CLOSING
+        {{AFTER_CLOSING, SKIP, false, -1},
+         {AFTER_CLOSING, SKIP, false, 3},
+         {AFTER_OPERATOR, BINARY_OPERATOR, false, -1},
+         {AFTER_OPERATOR, BINARY_OPERATOR, false, -1},
+         {AFTER_CLOSING, SKIP, false, 3},
+         {AFTER_CLOSING, CLOSE_GROUP, false, -1},
+         {AFTER_CLOSING, SKIP, false, 3},
+         {AFTER_CLOSING, SKIP, false, 2},
+         {AFTER_CLOSING, SKIP, false, -1}}};
+};
+
+/**
+ * @brief Lexer Class
+ *
+ * Reads the Terms of an expression text, finding the syntax errors (E1 to
+ * E7, see Errors) on the way, one character by step of the LexerTable
+ * automaton. It's constexpr, so the same rules are used by the Expression
+ * and by the compile time evaluation (see bares::eval).
+ *
+ * A Lexer reads its expression once.
+ */
+template <typename Policy>
+class BasicLexer {
+ public:
+    typedef typename Policy::value_type value_type;  //!< The numbers type
+    typedef BasicTerm<value_type> Term;              //!< The Term type
+
+    /**
+     * @brief Lexer Constructor
+     * @param _expr The expression text (must outlive the Lexer)
+     */
+    constexpr explicit BasicLexer(std::string_view _expr) : m_expr(_expr) {}
+
+    /**
+     * @brief Read all expression Terms
+     * @param _sink The function called with each Term, in infix order (it
+     * stops the Lexer returning False)
+     * @param _find_variable The function that finds a declared variable
+     * starting on a column (see Expression::find_variable)
+     *
+     * @return True if everything is ok, False if not
+     */
+    template <typename Sink, typename Finder>
+    constexpr bool lex(Sink &&_sink, Finder &&_find_variable);
+
+    /**
+     * @brief Read all expression Terms, without variables
+     * @param _sink The function called with each Term, in infix order
+     *
+     * @return True if everything is ok, False if not
+     */
+    template <typename Sink>
+    constexpr bool lex(Sink &&_sink) {
+        return lex(_sink, [](unsigned, unsigned &, int &) { return false; });
+    }
+
+    /**
+     * @brief Read all expression Terms, only on the characters where a
+     * Term begins
+     * @param _starts The bitmap of the Terms begin (see Kernels::scan)
+     * @param _sink The function called with each Term, in infix order
+     * @param _find_variable The function that finds a declared variable
+     * @see lex
+     *
+     * @return True if everything is ok, False if not
+     */
+    template <typename Sink, typename Finder>
+    constexpr bool lex(const std::uint64_t *_starts, Sink &&_sink,
+                       Finder &&_find_variable);
+
+    /**
+     * @brief Gets the syntax error id
+     * @return The error id (-1 if there is no error, or the sink failed)
+     */
+    constexpr int error_id() const { return m_error.id; }
+
+    /**
+     * @brief Gets the syntax error column
+     * @return The error column (-1 if there is no error)
+     */
+    constexpr int error_col() const { return m_error.col; }
+
+ private:
+    typedef BasicArithmetic<Policy> Arithmetic;  //!< The operations
+    typedef LexerTable Table;                    //!< The Lexer automaton
+
+    /**
+     * @brief Read a character
+     * @param i The character position (moved to the last character read)
+     * @param _sink The function called with each Term
+     * @param _find_variable The function that finds a declared variable
+     *
+     * @return True if everything is ok, False if not
+     */
+    template <typename Sink, typename Finder>
+    constexpr bool step(unsigned &i, Sink &&_sink, Finder &&_find_variable);
+
+    /**
+     * @brief Read the line end
+     * @param _sink The function called with the last Term
+     *
+     * @return True if everything is ok, False if not
+     */
+    template <typename Sink>
+    constexpr bool finish(Sink &&_sink);
+
+    /**
+     * @brief Function to set error
+     * @param _id The error id
+     * @param _col The error col
+     */
+    constexpr void set_error(const int _id, const int _col) {
+        m_error.id  = _id;
+        m_error.col = _col;
+    }
+
+    //! The error structure
+    struct {
+        int id = -1;   //!< The error code
+        int col = -1;  //!< The error column
+    } m_error;
+    std::string_view m_expr;  //!< The expression text
+    Table::State m_state = Table::AFTER_NOTHING;  //!< The automaton state
+    int m_parenthesis_diff = 0;  //!< The parentheses opened and not closed
+    int m_fst_parenthesis = -1;  //!< The column of the outer parenthesis
+    int m_digits = 0;            //!< The digits of the number being read
+    Term m_number;               //!< The number (or variable) being read
+};
+
+//! The Lexer of the default (16-bit) evaluator
+typedef BasicLexer<Int16> Lexer;
+
+#include "lexer.inl"
+
+#endif
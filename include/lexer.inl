@@ -0,0 +1,164 @@
+/*!
+ *  @file lexer.inl
+ *  @brief Lexer Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with Lexer Class implementations
+ */
+
+#include <limits>
+
+#include "lexer.hpp"
+
+// Lexer
+template <typename Policy>
+template <typename Sink, typename Finder>
+constexpr bool BasicLexer<Policy>::lex(Sink &&_sink, Finder &&_find_variable) {
+    for (auto i(0u); i < m_expr.size(); i++)
+        if (!step(i, _sink, _find_variable))
+            return false;
+    return finish(_sink);
+}
+
+// Lexer (by the Terms begin)
+template <typename Policy>
+template <typename Sink, typename Finder>
+constexpr bool BasicLexer<Policy>::lex(const std::uint64_t *_starts,
+                                       Sink &&_sink,
+                                       Finder &&_find_variable) {
+    // The first character not read
+    unsigned _next = 0;
+    for (auto _word(0u); _word * 64 < m_expr.size(); _word++) {
+        for (auto _bits = _starts[_word]; _bits != 0; _bits &= _bits - 1) {
+            unsigned i = _word * 64 + __builtin_ctzll(_bits);
+            // Skip the rest of a variable name
+            if (i < _next)
+                continue;
+            // The characters skipped before are whitespaces (which only
+            // change the state)
+            if (i > _next)
+                m_state = Table::transitions[m_state][Table::SPACE].next;
+            if (!step(i, _sink, _find_variable))
+                return false;
+            // And so the other digits of a number
+            if (m_state == Table::AFTER_NUMBER)
+                while (i + 1 < m_expr.size() &&
+                       Table::classes[static_cast<unsigned char>(
+                           m_expr[i + 1])] == Table::DIGIT)
+                    if (!step(++i, _sink, _find_variable))
+                        return false;
+            _next = i + 1;
+        }
+    }
+    if (_next < m_expr.size())
+        m_state = Table::transitions[m_state][Table::SPACE].next;
+    return finish(_sink);
+}
+
+// Read a character
+template <typename Policy>
+template <typename Sink, typename Finder>
+constexpr bool BasicLexer<Policy>::step(unsigned &i, Sink &&_sink,
+                                        Finder &&_find_variable) {
+    const char c = m_expr[i];
+    Table::Class _class = Table::classes[static_cast<unsigned char>(c)];
+    unsigned _end = 0;
+    int _index = 0;
+    // Any other character must be the begin of a declared variable
+    if (_class == Table::VARIABLE && !_find_variable(i, _end, _index))
+        _class = Table::INVALID;
+    // A closing parenthesis without an opening one comes before the other
+    // errors
+    if (_class == Table::CLOSING && m_parenthesis_diff == 0) {
+        set_error(4, i);
+        return false;
+    }
+
+    const Table::Transition &_next = Table::transitions[m_state][_class];
+    if (_next.error >= 0) {
+        set_error(_next.error, i);
+        return false;
+    }
+    // Send the number (or variable) ended by this character
+    if (_next.emit && !_sink(m_number))
+        return false;
+    m_state = _next.next;
+
+    Term t2;
+    switch (_next.action) {
+        case Table::NEW_NUMBER:
+            m_number.set(Term::NUMBER, c - '0', i);
+            m_digits = 1;
+            break;
+        case Table::NEXT_DIGIT: {
+            // Accumulate the digit on the number being read (checking the
+            // type overflow only if max_digits digits may not fit on it)
+            bool _overflow = false;
+            if constexpr (Policy::max_digits <=
+                          std::numeric_limits<value_type>::digits10) {
+                m_number.value = m_number.value * 10 + (c - '0');
+            } else {
+                _overflow =
+                    __builtin_mul_overflow(m_number.value, 10,
+                                           &m_number.value) ||
+                    __builtin_add_overflow(m_number.value, c - '0',
+                                           &m_number.value);
+            }
+            // Verify if is a too big number (more than max_digits digits)
+            // or out of range
+            if (_overflow || ++m_digits > Policy::max_digits ||
+                !Arithmetic::is_valid_number(m_number.value)) {
+                set_error(0, m_number.col);
+                return false;
+            }
+            break;
+        }
+        case Table::BINARY_OPERATOR:
+        case Table::UNARY_OPERATOR:
+            // An operator can't be the last character
+            if (i == m_expr.size() - 1) {
+                set_error(1, i + 1);
+                return false;
+            }
+            t2.set(Term::OPERATOR, c, i,
+                   _next.action == Table::UNARY_OPERATOR);
+            return _sink(t2);
+        case Table::OPEN_GROUP:
+            if (m_parenthesis_diff++ == 0)
+                m_fst_parenthesis = i;
+            t2.set(Term::OPENING_PARENTHESIS, c, i);
+            return _sink(t2);
+        case Table::CLOSE_GROUP:
+            m_parenthesis_diff--;
+            t2.set(Term::CLOSING_PARENTHESIS, c, i);
+            return _sink(t2);
+        case Table::READ_VARIABLE:
+            m_number.set(Term::VARIABLE, _index, i);
+            // Skip to the last character of the variable name
+            i = _end - 1;
+            break;
+        case Table::SKIP:
+            break;
+    }
+    return true;
+}
+
+// Read the line end
+template <typename Policy>
+template <typename Sink>
+constexpr bool BasicLexer<Policy>::finish(Sink &&_sink) {
+    const Table::Transition &_next = Table::transitions[m_state][Table::END];
+    if (_next.error >= 0) {
+        set_error(_next.error, m_expr.size());
+        return false;
+    }
+    if (_next.emit && !_sink(m_number))
+        return false;
+
+    if (m_parenthesis_diff != 0) {
+        set_error(6, m_fst_parenthesis);
+        return false;
+    }
+
+    return true;
+}
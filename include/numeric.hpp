@@ -0,0 +1,56 @@
+/*!
+ *  @file numeric.hpp
+ *  @brief Numeric Policies Declaration
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the numeric policies used by the evaluator
+ */
+
+#ifndef _numeric_hpp_
+#define _numeric_hpp_
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief The Int16 policy
+ *
+ * The original range, [-32.768, 32.767], computed on int (so a single
+ * operation never overflows the type and only the range is checked)
+ */
+struct Int16 {
+    typedef int value_type;                   //!< The values type
+    static constexpr value_type min = -32768;  //!< The minimum value
+    static constexpr value_type max = 32767;   //!< The maximum value
+    static constexpr int max_digits = 6;      //!< The digits of a constant
+};
+
+/**
+ * @brief The Int32 policy
+ *
+ * The whole 32-bit range (the overflow of the type is the range check)
+ */
+struct Int32 {
+    typedef std::int32_t value_type;  //!< The values type
+    //! The minimum value
+    static constexpr value_type min = std::numeric_limits<value_type>::min();
+    //! The maximum value
+    static constexpr value_type max = std::numeric_limits<value_type>::max();
+    static constexpr int max_digits = 10;  //!< The digits of a constant
+};
+
+/**
+ * @brief The Int64 policy
+ *
+ * The whole 64-bit range (the overflow of the type is the range check)
+ */
+struct Int64 {
+    typedef std::int64_t value_type;  //!< The values type
+    //! The minimum value
+    static constexpr value_type min = std::numeric_limits<value_type>::min();
+    //! The maximum value
+    static constexpr value_type max = std::numeric_limits<value_type>::max();
+    static constexpr int max_digits = 19;  //!< The digits of a constant
+};
+
+#endif
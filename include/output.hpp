@@ -0,0 +1,118 @@
+/*!
+ *  @file output.hpp
+ *  @brief Output Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Output Class header
+ */
+
+#ifndef _output_hpp_
+#define _output_hpp_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "result.hpp"
+
+/**
+ * @brief Output Class
+ *
+ * Writes the results on a file through a large buffer, which is only
+ * flushed when full (or on destruction). The results are formatted
+ * straight into the buffer, without temporary strings.
+ */
+class Output {
+ public:
+    /**
+     * @brief The maximum size of a formatted Result (line break included)
+     */
+    static const std::size_t MAX_LINE = 128;
+
+    /**
+     * @brief Output Constructor
+     * @param _path The file path (created or truncated)
+     * @param _capacity The buffer size (default = 1 MiB)
+     */
+    explicit Output(const std::string &_path, std::size_t _capacity = 1 << 20);
+
+    /**
+     * @brief Output Constructor
+     * @param _fd An opened file descriptor (e.g. 1 for the standard output)
+     * @param _capacity The buffer size (default = 1 MiB)
+     *
+     * Writes on a file descriptor, which isn't closed on destruction
+     */
+    explicit Output(int _fd, std::size_t _capacity = 1 << 20);
+
+    /**
+     * @brief Output Destructor
+     *
+     * Flush the buffer and close the file (if it was opened here)
+     */
+    ~Output();
+
+    Output(const Output &) = delete;
+    Output &operator=(const Output &) = delete;
+
+    /**
+     * @brief Verify if the Output was opened and all writes succeeded
+     * @return True if is good, False otherwise
+     */
+    bool good() const;
+
+    /**
+     * @brief Write a Result line
+     * @param _result The Result
+     */
+    void write(const Result &_result);
+
+    /**
+     * @brief Write a text as it is
+     * @param _text The text (e.g. already formatted lines)
+     */
+    void write(std::string_view _text);
+
+    /**
+     * @brief Write the buffer content on the file
+     * @return True if all succeed, False otherwise
+     */
+    bool flush();
+
+    /**
+     * @brief Format a Result line
+     * @param _result The Result
+     * @param _dst The destination (with room for MAX_LINE characters)
+     * @return A pointer after the last written character
+     *
+     * Formats the value or the error message (as Errors::get_error_message)
+     * followed by a line break. An empty Result is an empty line.
+     */
+    static char *format(const Result &_result, char *_dst);
+
+    /**
+     * @brief Format an integer
+     * @param _value The integer
+     * @param _dst The destination (with room for 20 characters)
+     * @return A pointer after the last written character
+     */
+    static char *format_integer(long long _value, char *_dst);
+
+ private:
+    /**
+     * @brief Write all bytes on the file
+     * @param _data The bytes
+     * @param _size The number of bytes
+     * @return True if all succeed, False otherwise
+     */
+    bool write_all(const char *_data, std::size_t _size);
+
+    int m_fd = -1;               //!< The file descriptor
+    bool m_owns_fd = false;      //!< Flag to indicate if closes the file
+    bool m_good = false;         //!< Flag to indicate if all writes succeeded
+    std::vector<char> m_buffer;  //!< The buffer
+    std::size_t m_size = 0;      //!< The buffer used size
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*!
+ *  @file perf_counters.hpp
+ *  @brief PerfCounters Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the PerfCounters Class header
+ */
+
+#ifndef _perf_counters_hpp_
+#define _perf_counters_hpp_
+
+#include <cstdint>
+#include <ostream>
+
+#include "profiler.hpp"
+
+/**
+ * @brief PerfCounters Class
+ *
+ * A Profiler that also sums the hardware counters (from the Linux
+ * perf_event_open) of each phase, on the thread that created it. When the
+ * counters aren't available (e.g. by the system permissions or on other
+ * systems), only the wall-clock time is measured.
+ */
+class PerfCounters : public Profiler {
+ public:
+    /**
+     * @brief The hardware counters
+     */
+    enum Counter {
+        CYCLES,         //!< The CPU cycles
+        INSTRUCTIONS,   //!< The instructions retired
+        BRANCH_MISSES,  //!< The branches mispredicted
+        CACHE_MISSES,   //!< The last level cache misses
+        COUNTERS        //!< The number of counters
+    };
+
+    /**
+     * @brief PerfCounters Constructor
+     *
+     * Opens the counters (of the user space only) for the calling thread
+     */
+    PerfCounters();
+
+    /**
+     * @brief PerfCounters Destructor
+     *
+     * Closes the counters
+     */
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /**
+     * @brief Verify if the hardware counters are available
+     * @return True if they're measured, False if only the time is
+     */
+    bool available() const;
+
+    /**
+     * @brief Start measuring a phase
+     * @param _phase The phase
+     */
+    void start(Phase _phase) override;
+
+    /**
+     * @brief Stop measuring a phase (started before)
+     * @param _phase The phase
+     */
+    void stop(Phase _phase) override;
+
+    /**
+     * @brief Gets a counter of a phase
+     * @param _phase The phase
+     * @param _counter The counter
+     * @return The counter sum (0 if isn't available)
+     */
+    std::uint64_t value(Phase _phase, Counter _counter) const;
+
+    /**
+     * @brief Gets the name of a counter
+     * @param _counter The counter
+     * @return The counter name (e.g. "cycles")
+     */
+    static const char *name(Counter _counter);
+
+    /**
+     * @brief Write the measures of each phase and their total, as CSV
+     * @param _out The stream
+     */
+    void report(std::ostream &_out) const;
+
+ private:
+    /**
+     * @brief Read the current counters
+     * @param _values Keep the counters
+     * @return True if they were read, False otherwise
+     */
+    bool read(std::uint64_t *_values) const;
+
+    int m_fds[COUNTERS];  //!< The counters (the first is the group leader)
+    bool m_available = false;                    //!< Flag of the counters
+    std::uint64_t m_start[COUNTERS] = {};        //!< The counters on start
+    std::uint64_t m_values[PHASES][COUNTERS] = {};  //!< The sums by phase
+};
+
+#endif
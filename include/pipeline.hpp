@@ -0,0 +1,123 @@
+/*!
+ *  @file pipeline.hpp
+ *  @brief Pipeline Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Pipeline Class header
+ */
+
+#ifndef _pipeline_hpp_
+#define _pipeline_hpp_
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "arena.hpp"
+#include "expression.hpp"
+#include "result.hpp"
+#include "result_cache.hpp"
+#include "spsc_ring.hpp"
+
+/**
+ * @brief Pipeline Class
+ *
+ * Evaluates a stream of lines (e.g. a pipe) in three stages, each one on
+ * its own thread: the reader reads blocks of whole lines, the evaluator
+ * evaluates them and formats the results in other blocks, and the writer
+ * writes these blocks. The stages pass the blocks through SpscRings, and
+ * the blocks come back to the stage filling them through other rings, so
+ * the memory is bounded: a slow stage holds back the ones before it.
+ */
+class Pipeline {
+ public:
+    /**
+     * @brief Pipeline Constructor
+     * @param _cache The cache of results (optional)
+     * @param _blocks The number of blocks of each kind (default = 8)
+     * @param _block_size The size of each block (default = 64 KiB)
+     *
+     * A block only grows beyond its size to fit a longer line
+     */
+    explicit Pipeline(ResultCache *_cache = nullptr, unsigned _blocks = 8,
+                      std::size_t _block_size = 1 << 16);
+
+    Pipeline(const Pipeline &) = delete;
+    Pipeline &operator=(const Pipeline &) = delete;
+
+    /**
+     * @brief Evaluate all lines
+     * @param _in The file descriptor to read the lines (e.g. 0)
+     * @param _out The file descriptor to write the results (e.g. 1)
+     * @return True if all lines were read and all results were written,
+     * False otherwise (see read_failed)
+     */
+    bool run(int _in, int _out);
+
+    /**
+     * @brief Verify if a read failed on the last run
+     * @return True if a read failed (the lines stop at the failure, so the
+     * input was evaluated only in part), False otherwise
+     */
+    bool read_failed() const;
+
+ private:
+    /**
+     * @brief The Block struct
+     */
+    struct Block {
+        std::vector<char> data;  //!< The content (lines or results)
+        std::size_t size = 0;    //!< The used size
+    };
+
+    /**
+     * @brief The reader stage
+     * @param _in The file descriptor
+     *
+     * Sends the blocks of whole lines (the last line of the input may have
+     * no line break), and then a null block, at the end of the input or on
+     * a read failure
+     */
+    void read(int _in);
+
+    /**
+     * @brief The evaluator stage
+     *
+     * Sends a block of results by block of lines (or more, if they don't
+     * fit), and then a null block
+     */
+    void evaluate();
+
+    /**
+     * @brief The writer stage
+     * @param _out The file descriptor
+     *
+     * Writes the blocks until the null block (and keeps taking them after a
+     * failed write, so the other stages finish)
+     */
+    void write(int _out);
+
+    /**
+     * @brief Evaluate a line, looking for it on the cache first
+     * @param _expr The line expression
+     * @param _return Keep the line Result
+     */
+    void calculate(std::string_view _expr, Result &_return);
+
+    ResultCache *m_cache;         //!< The cache of results (or null)
+    std::vector<Block> m_lines;   //!< The blocks of lines
+    std::vector<Block> m_results; //!< The blocks of results
+    SpscRing<Block *> m_read;     //!< The blocks read (to the evaluator)
+    SpscRing<Block *> m_free_lines;    //!< The blocks free (to the reader)
+    SpscRing<Block *> m_evaluated;     //!< The results (to the writer)
+    SpscRing<Block *> m_free_results;  //!< The blocks free (to the evaluator)
+    //! The memory of the Expression buffers
+    Arena m_arena;
+    //! The Expression reset to each line, keeping its buffers warm
+    Expression m_expr{std::string_view(), &m_arena};
+    Result m_result;     //!< The result of the current line
+    bool m_good = true;  //!< Flag to indicate if all writes succeeded
+    bool m_read_failed = false;  //!< Flag to indicate if a read failed
+};
+
+#endif
@@ -0,0 +1,80 @@
+/*!
+ *  @file profiler.hpp
+ *  @brief Profiler Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Profiler Class header
+ */
+
+#ifndef _profiler_hpp_
+#define _profiler_hpp_
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Profiler Class
+ *
+ * Sums the wall-clock time spent on each phase of the evaluation, over all
+ * the lines evaluated with it (see Expression::calculate). A subclass can
+ * measure something else on the same phases.
+ */
+class Profiler {
+ public:
+    /**
+     * @brief The evaluation phases
+     */
+    enum Phase {
+        TOKENIZE,       //!< Read the expression terms
+        INFIX2POSTFIX,  //!< Convert the terms to postfix
+        GET_RESULT,     //!< Evaluate the postfix terms
+        OUTPUT,         //!< Format and write the result
+        PHASES          //!< The number of phases
+    };
+
+    /**
+     * @brief Profiler Destructor
+     */
+    virtual ~Profiler();
+
+    /**
+     * @brief Start measuring a phase
+     * @param _phase The phase
+     */
+    virtual void start(Phase _phase);
+
+    /**
+     * @brief Stop measuring a phase (started before)
+     * @param _phase The phase
+     */
+    virtual void stop(Phase _phase);
+
+    /**
+     * @brief Gets the time spent on a phase
+     * @param _phase The phase
+     * @return The nanoseconds
+     */
+    std::uint64_t nanoseconds(Phase _phase) const;
+
+    /**
+     * @brief Gets how many times a phase was measured
+     * @param _phase The phase
+     * @return The number of times
+     */
+    std::uint64_t count(Phase _phase) const;
+
+    /**
+     * @brief Gets the name of a phase
+     * @param _phase The phase
+     * @return The phase name (e.g. "tokenize")
+     */
+    static const char *name(Phase _phase);
+
+ private:
+    //! The start of the phase being measured
+    std::chrono::steady_clock::time_point m_start;
+    std::uint64_t m_nanoseconds[PHASES] = {};  //!< The time by phase
+    std::uint64_t m_count[PHASES] = {};        //!< The measures by phase
+};
+
+#endif
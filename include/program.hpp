@@ -0,0 +1,205 @@
+/*!
+ *  @file program.hpp
+ *  @brief Program Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Program Class header
+ */
+
+#ifndef _program_hpp_
+#define _program_hpp_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "result.hpp"
+
+/**
+ * @brief Program Class
+ *
+ * A compiled Expression: a flat array with the postfix terms as opcodes and
+ * constants. It can't be changed after the compilation, so it can be
+ * evaluated any number of times, from any thread, without parsing again.
+ *
+ * @see Expression::compile
+ */
+class Program {
+ public:
+    /**
+     * @brief The Program opcodes
+     *
+     * The binary operators use their own symbols as opcodes.
+     */
+    enum Opcode : unsigned char {
+        PUSH = 0,    //!< Push a constant on the operands Stack
+        LOAD = 1,    //!< Push a variable value on the operands Stack
+        NEG  = '~',  //!< Unary minus
+        ADD  = '+',  //!< Addition
+        SUB  = '-',  //!< Subtraction
+        MUL  = '*',  //!< Multiplication
+        DIV  = '/',  //!< Division
+        MOD  = '%',  //!< Modulo
+        POW  = '^'   //!< Exponentiation
+    };
+
+    /**
+     * @brief The Instruction struct
+     */
+    struct Instruction {
+        Opcode op;  //!< The instruction opcode
+        int value;  //!< The constant (PUSH) or the variable id (LOAD)
+    };
+
+    /**
+     * @brief Program Constructor
+     *
+     * Creates an empty Program (which has an empty result)
+     */
+    Program() = default;
+
+    /**
+     * @brief Evaluate the Program
+     * @param _return The var to keep the result
+     * @param _error The var to keep the error id (if any)
+     *
+     * @return True if all succeed, False otherwise
+     */
+    bool eval(int &_return, int &_error) const;
+
+    /**
+     * @brief Evaluate the Program with variables
+     * @param _variables The value of each variable (by id)
+     * @param _return The var to keep the result
+     * @param _error The var to keep the error id (if any)
+     *
+     * A variable value must fit in the numeric range like any operand,
+     * otherwise it's a numeric overflow error.
+     *
+     * @return True if all succeed, False otherwise
+     */
+    bool eval(const int *_variables, int &_return, int &_error) const;
+
+    /**
+     * @brief Evaluate instructions in place (e.g. mapped from a file)
+     * @param _program The instructions (of a valid Program)
+     * @param _size The number of instructions
+     * @param _depth The operands Stack max size (a hint to reserve it)
+     * @param _variables The value of each variable (by id)
+     * @param _return The var to keep the result
+     * @param _error The var to keep the error id (if any)
+     * @param _failed The var to keep the index of the instruction that
+     * failed (optional)
+     * @see ProgramFile
+     *
+     * @return True if all succeed, False otherwise
+     */
+    static bool eval(const Instruction *_program, std::size_t _size,
+                     unsigned _depth, const int *_variables, int &_return,
+                     int &_error, std::size_t *_failed = nullptr);
+
+    /**
+     * @brief Evaluate the Program over many rows of variables
+     * @param _columns The values of each variable (one array per id)
+     * @param _size The number of rows
+     * @param _return The array to keep the results
+     * @param _errors The array to keep the error ids (-1 if succeeded)
+     * @see Kernels
+     *
+     * Gives the same results as eval on each row, but each instruction is
+     * applied to a block of rows at once with the vectorized Kernels.
+     */
+    void eval_batch(const int *const *_columns, unsigned _size, int *_return,
+                    int *_errors) const;
+
+    /**
+     * @brief Evaluate the Program
+     * @param _return The Result (as Expression::calculate)
+     *
+     * @return True if all succeed, False otherwise
+     */
+    bool eval(Result &_return) const;
+
+    /**
+     * @brief Evaluate the Program
+     * @param _return The result or error message (as Expression::calculate)
+     *
+     * @return True if all succeed, False otherwise
+     */
+    bool eval(std::string &_return) const;
+
+    /**
+     * @brief Verify if the Program was successfully compiled
+     * @return True if it has no compilation error, False otherwise
+     */
+    bool is_valid() const;
+
+    /**
+     * @brief Verify if the Program has no instructions
+     * @return True if the Program is empty, False otherwise
+     */
+    bool empty() const;
+
+    /**
+     * @brief Gets the number of variables
+     * @return The number of variables declared on compilation
+     */
+    unsigned variables() const;
+
+    /**
+     * @brief Gets the operands Stack max size
+     * @return The maximum number of operands on the Stack while evaluating
+     */
+    unsigned depth() const;
+
+    /**
+     * @brief Gets the leading zeros of the value
+     * @return The leading zeros printed with the value (see
+     * BasicExpression::leading_zeros)
+     */
+    int zeros() const;
+
+    /**
+     * @brief Gets the Program instructions
+     * @return A reference to the instructions array
+     */
+    const std::vector<Instruction> &instructions() const;
+
+    /**
+     * @brief Gets the column of each instruction
+     * @return A reference to the columns array (the column of the term of
+     * each instruction on the expression)
+     */
+    const std::vector<int> &columns() const;
+
+    /**
+     * @brief Gets the compilation error id
+     * @return The error id (-1 if there is no error)
+     */
+    int error_id() const;
+
+    /**
+     * @brief Gets the compilation error column
+     * @return The error column (-1 if there is no error)
+     */
+    int error_col() const;
+
+ private:
+    template <typename Policy>
+    friend class BasicExpression;
+
+    //! The compilation error structure
+    struct {
+        int id = -1;   //!< The error code
+        int col = -1;  //!< The error column
+    } m_error;
+    unsigned m_depth = 0;                  //!< The operands Stack max size
+    unsigned m_variables = 0;              //!< The number of variables
+    int m_zeros = 0;                       //!< The value leading zeros
+    //! False if an operator can find the operands Stack empty (e.g. "(+2)")
+    bool m_balanced = true;
+    std::vector<Instruction> m_program;    //!< The instructions
+    std::vector<int> m_columns;            //!< The instructions columns
+};
+
+#endif
@@ -0,0 +1,130 @@
+/*!
+ *  @file program_file.hpp
+ *  @brief Program File Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Program File Class header
+ */
+
+#ifndef _program_file_hpp_
+#define _program_file_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "input.hpp"
+#include "program.hpp"
+#include "result.hpp"
+
+/**
+ * @brief Program File Class
+ *
+ * A file with the compiled Programs of all lines of an input, so they can
+ * be evaluated again (e.g. on another run) without parsing the lines. The
+ * file is mapped on memory and each Program is evaluated in place, straight
+ * from the mapping, without reading it to a Program first.
+ *
+ * The format (version 2) has all numbers on the byte order of the machine
+ * that wrote it, and all parts 8-byte aligned: a header, a record by line
+ * (its compilation error, operands Stack depth, number of instructions and
+ * value leading zeros, followed by the instructions and the column of each
+ * one on the line) and an index with the position of each record. The
+ * header has the checksum of everything after it.
+ *
+ * 16-bit only, as the Programs (see Expression::compile).
+ */
+class ProgramFile {
+ public:
+    /**
+     * @brief The file format version
+     */
+    static const std::uint32_t VERSION = 2;
+
+    /**
+     * @brief The load status
+     */
+    enum Status {
+        OK,            //!< The file was loaded
+        CANNOT_OPEN,   //!< The file can't be opened or mapped
+        BAD_FORMAT,    //!< The file isn't a Program file, or is truncated
+        BAD_VERSION,   //!< Another version or byte order
+        BAD_CHECKSUM   //!< The file was changed after written
+    };
+
+    /**
+     * @brief Program File Constructor
+     * @param _path The file path
+     *
+     * Maps the file and verifies it (header, checksum, records and opcodes)
+     */
+    explicit ProgramFile(const std::string &_path);
+
+    /**
+     * @brief Program File Destructor
+     *
+     * Unmap and close the file
+     */
+    ~ProgramFile();
+
+    ProgramFile(const ProgramFile &) = delete;
+    ProgramFile &operator=(const ProgramFile &) = delete;
+
+    /**
+     * @brief Gets the load status
+     * @return The status (OK if the Programs can be evaluated)
+     */
+    Status status() const;
+
+    /**
+     * @brief Gets the number of Programs
+     * @return The number of Programs (one by line of the input)
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Evaluate a Program in place
+     * @param _index The Program position (its line on the input)
+     * @param _return The Result (value or error), the same of an Expression
+     * @param _column The var to keep the column of the error on the line:
+     * the syntax error, or the operator that failed (optional)
+     *
+     * @return True if all succeed, False if not
+     */
+    bool eval(std::size_t _index, Result &_return,
+              int *_column = nullptr) const;
+
+    /**
+     * @brief Compile all lines of an input to a Program file
+     * @param _path The file path (created or truncated)
+     * @param _input The input lines
+     *
+     * @return True if all succeed, False if the input can't be read or the
+     * file can't be written
+     */
+    static bool write(const std::string &_path, Input &_input);
+
+ private:
+    struct Header;
+    struct Record;
+
+    /**
+     * @brief Verify the mapped file
+     * @return The load status
+     */
+    Status verify() const;
+
+    /**
+     * @brief Gets the record of a Program
+     * @param _index The Program position
+     * @return The record, on the mapping
+     */
+    const Record *record(std::size_t _index) const;
+
+    int m_fd = -1;                 //!< The file descriptor
+    const char *m_data = nullptr;  //!< The mapping
+    std::size_t m_size = 0;        //!< The file size
+    Status m_status = CANNOT_OPEN;  //!< The load status
+};
+
+#endif
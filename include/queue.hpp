@@ -9,21 +9,56 @@
 #ifndef _queue_hpp_
 #define _queue_hpp_
 
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+
 /**
  * @brief Queue Class
  *
- * The Queue implementation.
+ * The Queue implementation, on a circular buffer that grows geometrically.
+ * The elements are moved (or copied, if they can't be moved safely) to the
+ * new buffer in a single pass, so move-only elements are supported.
+ * The buffer comes from the Allocator (e.g. a std::pmr::polymorphic_allocator
+ * on an Arena).
  */
-template <typename Object>
+template <typename Object, typename Allocator = std::allocator<Object>>
 class Queue {
  public:
     /**
      * @brief Queue Constructor
      * @param _sz Receives the initial Queue size
+     * @param _allocator The buffer allocator
+     *
+     * Creates a Queue with _sz size (default = 1)
+     */
+    explicit Queue(const unsigned _sz = 1,
+                   const Allocator &_allocator = Allocator());
+
+    /**
+     * @brief Queue Move Constructor
+     * @param _other The Queue to be moved (left empty, without buffer)
      *
-     * Creates a Stack with _sz size (default = 1)
+     * Doesn't allocate: takes the other buffer
      */
-    explicit Queue(const unsigned _sz = 1);
+    Queue(Queue &&_other) noexcept;
+
+    /**
+     * @brief Queue Move Assignment
+     * @param _other The Queue to be moved (left empty, with the buffer of
+     * this one when they are swapped)
+     * @return This Queue
+     *
+     * Only allocates to move the buffer of another (not equal) allocator,
+     * throwing std::bad_alloc if it can't (and then the other Queue is kept)
+     */
+    Queue &operator=(Queue &&_other) noexcept(
+        std::allocator_traits<Allocator>::is_always_equal::value &&
+        std::is_nothrow_move_constructible<Object>::value);
+
+    Queue(const Queue &) = delete;
+    Queue &operator=(const Queue &) = delete;
 
     /**
      * @brief Queue Destructor
@@ -39,26 +74,67 @@ class Queue {
      */
     bool enqueue(const Object &_x);
 
+    /**
+     * @brief Insert an element on Queue
+     * @param _x Receives an element to be moved to the Queue
+     * @return True if the element was successfully enqueued, False otherwise
+     */
+    bool enqueue(Object &&_x);
+
+    /**
+     * @brief Construct an element on the rear of the Queue
+     * @param _args The element constructor arguments
+     * @return True if the element was successfully enqueued, False otherwise
+     */
+    template <typename... Args>
+    bool emplace(Args &&... _args);
+
     /**
      * @brief Remove an element from Queue
-     * @param _return Keep the removed element
+     * @param _return Keep the removed element (moved from the Queue)
      * @return True if the element was successfully removed, False otherwise
      */
     bool dequeue(Object &_return);
 
     /**
      * @brief Gets the element on front of Queue
-     * @param _return Keep the front element
+     * @param _return Keep a copy of the front element
      * @return True if the element was successfully accessed, False otherwise
      */
     bool front(Object &_return) const;
 
+    /**
+     * @brief Gets the element on front of Queue
+     * @return A reference to the front element (the Queue must not be
+     * empty), without copying it (e.g. a move-only element)
+     */
+    Object &front();
+
+    /**
+     * @brief Gets the element on front of Queue
+     * @return A reference to the front element (the Queue must not be empty)
+     */
+    const Object &front() const;
+
     /**
      * @brief Get the Queue size
      * @return A unsigned int with the Queue size
      */
     unsigned size() const;
 
+    /**
+     * @brief Get the Queue capacity
+     * @return The number of elements it keeps without growing
+     */
+    unsigned capacity() const;
+
+    /**
+     * @brief Reserve space for elements
+     * @param _sz The number of elements
+     * @return True if the Queue can keep _sz elements, False otherwise
+     */
+    bool reserve(const unsigned _sz);
+
     /**
      * @brief Verify if the Queue is Empty
      * @return True if the Queue is Empty, False if not
@@ -72,7 +148,7 @@ class Queue {
     bool isFull() const;
 
     /**
-     * @brief Make the Queue empty
+     * @brief Make the Queue empty, keeping its capacity
      * @return True if the Queue was successfully empty, False if not
      */
     bool makeEmpty();
@@ -86,8 +162,8 @@ class Queue {
     inline friend
     std::ostream &operator<<(std::ostream &_os, const Queue &_queue) {
         _os << "[ ";
-        for (auto i(0u); i < _queue.size(); i++)
-            _os << _queue.m_queue[(_queue.m_f + i) % _queue.m_capacity] << " ";
+        for (auto i(0u); i < _queue.m_size; i++)
+            _os << _queue.m_queue[_queue._index(i)] << " ";
         _os << "]";
 
         return _os;
@@ -95,14 +171,37 @@ class Queue {
 
  private:
     /**
-     * @brief Double the Stack capacity
-     * @return True if the Stack successfully grew, False otherwise
+     * @brief Double the Queue capacity
+     * @return True if the Queue successfully grew, False otherwise
      */
     bool _double();
 
-    int m_f         = -1;       //!< The position of the front of Queue
-    int m_r         = -1;       //!< The position of the rear of the Queue
-    int m_capacity  = 0;        //!< The Queue capacity
+    /**
+     * @brief Move the elements to a new buffer, with the front at 0
+     * @param _sz The new buffer capacity
+     * @return True if the buffer was allocated, False otherwise
+     *
+     * An element copy that throws is rethrown, with the Queue as it was
+     */
+    bool _relocate(const unsigned _sz);
+
+    //! The Allocator traits
+    typedef std::allocator_traits<Allocator> Traits;
+
+    /**
+     * @brief Gets the buffer position of an element
+     * @param _i The element position, from the front
+     * @return The buffer position
+     */
+    unsigned _index(const unsigned _i) const {
+        auto _pos = m_f + _i;
+        return _pos < m_capacity ? _pos : _pos - m_capacity;
+    }
+
+    Allocator m_allocator;      //!< The buffer allocator
+    unsigned m_f        = 0;    //!< The position of the front of Queue
+    unsigned m_size     = 0;    //!< The number of elements on Queue
+    unsigned m_capacity = 0;    //!< The Queue capacity
     Object *m_queue = nullptr;  //!< A pointer to the first element on memory
 };
 
@@ -6,58 +6,104 @@
  *  File with Queue Class implementations
  */
 
-#include "stack.hpp"
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "queue.hpp"
 
 // Constructor
-template <typename Object>
-Queue<Object>::Queue(const unsigned _sz) {
-    m_capacity = _sz;
-    m_queue = new Object[_sz];
+template <typename Object, typename Allocator>
+Queue<Object, Allocator>::Queue(const unsigned _sz,
+                                const Allocator &_allocator)
+    : m_allocator(_allocator) {
+    reserve(_sz);
 }
 
-// Destructor
-template <typename Object>
-Queue<Object>::~Queue() {
-    delete[] m_queue;
+// Move Constructor
+template <typename Object, typename Allocator>
+Queue<Object, Allocator>::Queue(Queue &&_other) noexcept
+    : m_allocator(_other.m_allocator), m_f(_other.m_f), m_size(_other.m_size),
+      m_capacity(_other.m_capacity), m_queue(_other.m_queue) {
+    _other.m_f = _other.m_size = _other.m_capacity = 0;
+    _other.m_queue = nullptr;
 }
 
-template <typename Object>
-bool Queue<Object>::enqueue(const Object &_a) {
-    if (m_f == -1) {
-        m_f = m_r = 0,
-        m_queue[0] = _a;
-        return true;
+// Move Assignment
+template <typename Object, typename Allocator>
+Queue<Object, Allocator> &Queue<Object, Allocator>::operator=(
+    Queue &&_other) noexcept(
+        std::allocator_traits<Allocator>::is_always_equal::value &&
+        std::is_nothrow_move_constructible<Object>::value) {
+    if (this == &_other)
+        return *this;
+
+    makeEmpty();
+    if (m_allocator == _other.m_allocator) {
+        std::swap(m_f, _other.m_f);
+        std::swap(m_size, _other.m_size);
+        std::swap(m_capacity, _other.m_capacity);
+        std::swap(m_queue, _other.m_queue);
+        return *this;
     }
+    // The buffer from another allocator can't be taken, so move one by one
+    // (which is never the case when all allocators are equal)
+    if (!reserve(_other.m_size)) {
+        if constexpr (!Traits::is_always_equal::value)
+            throw std::bad_alloc();
+    }
+    for (auto i(0u); i < _other.m_size; i++)
+        new (m_queue + i) Object(std::move(_other.m_queue[_other._index(i)]));
+    m_size = _other.m_size;
+    _other.makeEmpty();
+    return *this;
+}
+
+// Destructor
+template <typename Object, typename Allocator>
+Queue<Object, Allocator>::~Queue() {
+    makeEmpty();
+    if (m_queue != nullptr)
+        Traits::deallocate(m_allocator, m_queue, m_capacity);
+}
+
+template <typename Object, typename Allocator>
+bool Queue<Object, Allocator>::enqueue(const Object &_a) {
+    return emplace(_a);
+}
 
+template <typename Object, typename Allocator>
+bool Queue<Object, Allocator>::enqueue(Object &&_a) {
+    return emplace(std::move(_a));
+}
+
+template <typename Object, typename Allocator>
+template <typename... Args>
+bool Queue<Object, Allocator>::emplace(Args &&... _args) {
     if (isFull())
         if (!_double())
             return false;
 
-    auto final_b = (m_r + 1)%m_capacity;
-    m_queue[final_b] = _a, m_r = final_b;
-
+    new (m_queue + _index(m_size)) Object(std::forward<Args>(_args)...);
+    m_size++;
     return true;
 }
 
-template <typename Object>
-bool Queue<Object>::dequeue(Object &_a) {
+template <typename Object, typename Allocator>
+bool Queue<Object, Allocator>::dequeue(Object &_a) {
     if (isEmpty())
         return false;
 
-    // Copy the front element
-    if(!front(_a))
-        return false;
-
-    if (m_r == m_f)
-        m_r = m_f = -1;
-    else
-        m_f = (m_f + 1)%m_capacity;
-
+    // Move the front element
+    _a = std::move(m_queue[m_f]);
+    m_queue[m_f].~Object();
+    m_f = _index(1);
+    m_size--;
     return true;
 }
 
-template <typename Object>
-bool Queue<Object>::front(Object &_a) const {
+template <typename Object, typename Allocator>
+bool Queue<Object, Allocator>::front(Object &_a) const {
     if (isEmpty())
         return false;
 
@@ -66,62 +112,85 @@ bool Queue<Object>::front(Object &_a) const {
     return true;
 }
 
-template <typename Object>
-unsigned Queue<Object>::size() const {
-    if (isEmpty())
-        return 0;
-    if (m_f > m_r)
-        return m_capacity - m_f + m_r + 1;
-    return m_r - m_f + 1;
+template <typename Object, typename Allocator>
+Object &Queue<Object, Allocator>::front() {
+    return m_queue[m_f];
 }
 
-template <typename Object>
-bool Queue<Object>::isEmpty() const {
-    return m_f == -1;
+template <typename Object, typename Allocator>
+const Object &Queue<Object, Allocator>::front() const {
+    return m_queue[m_f];
 }
 
-template <typename Object>
-bool Queue<Object>::isFull() const {
-    return (m_r + 1)%m_capacity == m_f;
+template <typename Object, typename Allocator>
+unsigned Queue<Object, Allocator>::size() const {
+    return m_size;
 }
 
-template <typename Object>
-bool Queue<Object>::makeEmpty() {
-    try {
-        delete[] m_queue;
-        m_queue = new Object;
-    } catch (std::bad_alloc &e) {
-        return false;
-    }
+template <typename Object, typename Allocator>
+unsigned Queue<Object, Allocator>::capacity() const {
+    return m_capacity;
+}
+
+template <typename Object, typename Allocator>
+bool Queue<Object, Allocator>::reserve(const unsigned _sz) {
+    return _sz <= m_capacity || _relocate(_sz);
+}
+
+template <typename Object, typename Allocator>
+bool Queue<Object, Allocator>::isEmpty() const {
+    return m_size == 0;
+}
+
+template <typename Object, typename Allocator>
+bool Queue<Object, Allocator>::isFull() const {
+    return m_size == m_capacity;
+}
 
-    m_f = m_r = -1;
-    m_capacity = 1;
+template <typename Object, typename Allocator>
+bool Queue<Object, Allocator>::makeEmpty() {
+    for (auto i(0u); i < m_size; i++)
+        m_queue[_index(i)].~Object();
+    m_f = m_size = 0;
     return true;
 }
 
 // Double Size
-template <typename Object>
-bool Queue<Object>::_double() {
-    Queue<Object> copy(m_capacity);
-    Object aux;
-    while (dequeue(aux))
-        if (!copy.enqueue(aux))
-            return false;
-
-    // Delete old Queue array to avoid memory leak
-    delete[] m_queue;
+template <typename Object, typename Allocator>
+bool Queue<Object, Allocator>::_double() {
+    return _relocate(m_capacity ? m_capacity * 2 : 1);
+}
 
+// Relocate
+template <typename Object, typename Allocator>
+bool Queue<Object, Allocator>::_relocate(const unsigned _sz) {
+    Object *_queue;
     try {
-        m_queue = new Object[m_capacity * 2];
+        _queue = Traits::allocate(m_allocator, _sz);
     } catch (std::bad_alloc &e) {
         return false;
     }
 
-    m_capacity *= 2;
-
-    while (copy.dequeue(aux))
-        if (!enqueue(aux))
-            return false;
+    // Move each element once (copy it if moving may throw), unwrapping the
+    // circular buffer so the front goes to the position 0, and only then
+    // destroy the old ones, so a copy that throws leaves the Queue as it is
+    auto i(0u);
+    try {
+        for (; i < m_size; i++)
+            new (_queue + i) Object(std::move_if_noexcept(m_queue[_index(i)]));
+    } catch (...) {
+        while (i > 0)
+            _queue[--i].~Object();
+        Traits::deallocate(m_allocator, _queue, _sz);
+        throw;
+    }
+    for (i = 0; i < m_size; i++)
+        m_queue[_index(i)].~Object();
 
+    if (m_queue != nullptr)
+        Traits::deallocate(m_allocator, m_queue, m_capacity);
+    m_queue    = _queue;
+    m_capacity = _sz;
+    m_f        = 0;
     return true;
 }
@@ -0,0 +1,40 @@
+/*!
+ *  @file result.hpp
+ *  @brief Result struct Declaration
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Result Struct header
+ */
+
+#ifndef _result_hpp_
+#define _result_hpp_
+
+/**
+ * @brief The Result struct
+ *
+ * The outcome of an expression evaluation: its value or the error (with
+ * the column, when the error has one). Only turned into text on output.
+ *
+ * The value type T fits the numbers of the evaluator numeric policy.
+ */
+template <typename T>
+struct BasicResult {
+    T value = 0;         //!< The expression value
+    int error = -1;      //!< The error id (-1 if there is no error)
+    int col = -1;        //!< The error column (-1 if the error has no column)
+    bool empty = false;  //!< Flag to indicate an expression without terms
+    //! The leading zeros of a value printed as written (see
+    //! BasicExpression::leading_zeros)
+    int zeros = 0;
+
+    /**
+     * @brief Verify if the Result is an error
+     * @return True if is an error, False otherwise
+     */
+    constexpr bool is_error() const { return error != -1; }
+};
+
+//! The Result of the default (16-bit) evaluator
+typedef BasicResult<int> Result;
+
+#endif
@@ -0,0 +1,119 @@
+/*!
+ *  @file result_cache.hpp
+ *  @brief ResultCache Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the ResultCache Class header
+ */
+
+#ifndef _result_cache_hpp_
+#define _result_cache_hpp_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "result.hpp"
+
+/**
+ * @brief ResultCache Class
+ *
+ * A bounded cache of expression Results, keyed by the expression text.
+ * The entries are split in shards (each one with its own lock), so it can
+ * be shared by many threads, and each shard evicts with the CLOCK policy.
+ * The whole text is compared on a lookup, so a hash collision is a miss.
+ */
+class ResultCache {
+ public:
+    /**
+     * @brief ResultCache Constructor
+     * @param _capacity The maximum number of entries (at least 1)
+     * @param _shards The number of shards (default = 16, at most one per
+     * entry)
+     */
+    explicit ResultCache(std::size_t _capacity, unsigned _shards = 16);
+
+    /**
+     * @brief Find the Result of an expression
+     * @param _expr The expression text
+     * @param _return Keep the Result found
+     * @return True if it was found (a hit), False otherwise (a miss)
+     */
+    bool find(std::string_view _expr, Result &_return);
+
+    /**
+     * @brief Insert the Result of an expression
+     * @param _expr The expression text
+     * @param _result The expression Result
+     *
+     * Evicts an entry that wasn't used recently when the shard is full
+     */
+    void insert(std::string_view _expr, const Result &_result);
+
+    /**
+     * @brief Get the maximum number of entries
+     * @return The capacity
+     */
+    std::size_t capacity() const;
+
+    /**
+     * @brief Get the number of hits
+     * @return The number of finds that succeeded
+     */
+    std::size_t hits() const;
+
+    /**
+     * @brief Get the number of misses
+     * @return The number of finds that failed
+     */
+    std::size_t misses() const;
+
+    /**
+     * @brief Hash an expression text
+     * @param _expr The expression text
+     * @return The 64-bit hash
+     */
+    static std::uint64_t hash(std::string_view _expr);
+
+ private:
+    /**
+     * @brief The Slot struct
+     */
+    struct Slot {
+        std::uint64_t hash = 0;   //!< The expression hash
+        std::string expr;         //!< The expression text
+        Result result;            //!< The expression Result
+        bool used = false;        //!< Flag to indicate it keeps an entry
+        bool referenced = false;  //!< Flag to indicate it was recently used
+    };
+
+    /**
+     * @brief The Shard struct
+     */
+    struct Shard {
+        std::mutex mutex;         //!< The shard lock
+        std::vector<Slot> slots;  //!< The entries
+        std::unordered_map<std::uint64_t, unsigned> index;  //!< Hash to slot
+        unsigned hand = 0;        //!< The CLOCK hand
+    };
+
+    /**
+     * @brief Gets the shard of a hash
+     * @param _hash The expression hash
+     * @return The shard
+     */
+    Shard &shard(std::uint64_t _hash);
+
+    std::size_t m_capacity;                       //!< The capacity
+    std::vector<std::unique_ptr<Shard>> m_shards;  //!< The shards
+    std::atomic<std::size_t> m_hits{0};           //!< The number of hits
+    std::atomic<std::size_t> m_misses{0};         //!< The number of misses
+};
+
+#endif
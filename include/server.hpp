@@ -0,0 +1,205 @@
+/*!
+ *  @file server.hpp
+ *  @brief Server Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Server Class header
+ */
+
+#ifndef _server_hpp_
+#define _server_hpp_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.hpp"
+#include "expression.hpp"
+#include "result.hpp"
+#include "result_cache.hpp"
+
+/**
+ * @brief Server Class
+ *
+ * Evaluates the expressions sent by local clients, on a Unix domain socket
+ * and (optionally) on a loopback TCP port. Each request is a line and each
+ * response is the line of its Result (as on the output files), in the same
+ * order, so a client may send many lines before reading the responses.
+ *
+ * A single thread waits on epoll for all sockets. The lines read from all
+ * connections on each wake up are evaluated as one batch, and then the
+ * responses are sent. A connection isn't read while it has too many
+ * responses waiting to be sent, so a client that doesn't read is held back.
+ */
+class Server {
+ public:
+    /**
+     * @brief Server Constructor
+     * @param _cache The cache of results (optional)
+     * @param _share Flag to evaluate equal subexpressions of a batch once
+     * @see Expression::calculate_batch
+     */
+    explicit Server(ResultCache *_cache = nullptr, bool _share = false);
+
+    /**
+     * @brief Server Destructor
+     *
+     * Close all sockets (and remove the Unix socket file)
+     */
+    ~Server();
+
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
+
+    /**
+     * @brief Listen on a Unix domain socket
+     * @param _path The socket path (an old socket there is replaced)
+     * @return True if it's listening, False otherwise
+     */
+    bool listen_unix(const std::string &_path);
+
+    /**
+     * @brief Listen on a TCP port of the loopback interface
+     * @param _port The port
+     * @return True if it's listening, False otherwise
+     */
+    bool listen_tcp(unsigned short _port);
+
+    /**
+     * @brief Serve the clients until stop is called
+     * @return True if it stopped normally, False on an epoll failure
+     */
+    bool run();
+
+    /**
+     * @brief Stop the server
+     *
+     * Only writes to a file descriptor, so it may be called from a signal
+     * handler (or another thread)
+     */
+    void stop();
+
+    /**
+     * @brief Write the statistics
+     * @param _os The output stream
+     *
+     * The connections, requests and batches served, and the percentiles of
+     * the latency of a request (from reading it to sending its response)
+     */
+    void report(std::ostream &_os) const;
+
+ private:
+    /**
+     * @brief The Connection struct
+     */
+    struct Connection {
+        int fd;                 //!< The socket
+        std::string input;      //!< The lines read (the last may be partial)
+        std::size_t parsed = 0; //!< The size of the whole lines taken
+        std::string output;     //!< The responses not sent yet
+        std::size_t sent = 0;   //!< The size of the output already sent
+        bool eof = false;       //!< Flag to indicate the client closed
+        bool failed = false;    //!< Flag to indicate a socket error
+        bool reading = true;    //!< Flag to indicate it's polled for input
+        bool writing = false;   //!< Flag to indicate it's polled for output
+        bool touched = false;   //!< Flag to indicate it's on this batch
+    };
+
+    /**
+     * @brief A latency histogram (log-linear, with 16 buckets by power of 2)
+     */
+    struct Histogram {
+        //! The number of buckets (enough for any 64-bit value)
+        static const unsigned BUCKETS = 1024;
+        std::uint64_t counts[BUCKETS] = {};  //!< The values by bucket
+        std::uint64_t total = 0;             //!< The number of values
+
+        /**
+         * @brief Count a value
+         * @param _ns The value (in nanoseconds)
+         * @param _n The number of times
+         */
+        void add(std::uint64_t _ns, std::uint64_t _n);
+
+        /**
+         * @brief Get a percentile
+         * @param _p The percentile (e.g. 0.99)
+         * @return The lowest value of the bucket with the percentile (at most
+         * 1/16 below the real value)
+         */
+        std::uint64_t percentile(double _p) const;
+    };
+
+    /**
+     * @brief Add a listening socket to the epoll
+     * @param _fd The socket (bound)
+     * @return True if all succeed, False otherwise
+     */
+    bool listen(int _fd);
+
+    /**
+     * @brief Accept all pending connections of a listening socket
+     * @param _fd The listening socket
+     */
+    void accept(int _fd);
+
+    /**
+     * @brief Read from a connection and take its whole lines to the batch
+     * @param _c The Connection
+     */
+    void receive(Connection &_c);
+
+    /**
+     * @brief Send the responses of a connection, as much as the socket takes
+     * @param _c The Connection
+     */
+    void send(Connection &_c);
+
+    /**
+     * @brief Evaluate the batch and append each response to its Connection
+     */
+    void evaluate();
+
+    /**
+     * @brief Update the events polled for a connection, or close it
+     * @param _c The Connection
+     * @return True if it's still open, False if it was closed
+     */
+    bool update(Connection &_c);
+
+    ResultCache *m_cache;  //!< The cache of results (or null)
+    bool m_share;          //!< Flag to share subexpressions
+    int m_epoll = -1;      //!< The epoll instance
+    int m_wakeup = -1;     //!< The eventfd written by stop
+    std::vector<int> m_listeners;  //!< The listening sockets
+    std::string m_path;            //!< The Unix socket path (or empty)
+    //! The open connections, by socket
+    std::unordered_map<int, std::unique_ptr<Connection>> m_connections;
+
+    std::vector<std::string_view> m_batch;  //!< The lines of the batch
+    std::vector<Connection *> m_owners;     //!< The Connection of each line
+    //! The time each line was read (its latency starts there)
+    std::vector<std::chrono::steady_clock::time_point> m_arrivals;
+    std::vector<Connection *> m_touched;    //!< The Connections of the batch
+    std::vector<Result> m_results;          //!< The Results of the batch
+    std::vector<std::string_view> m_misses; //!< The lines not cached
+    std::vector<Result> m_miss_results;     //!< The Results not cached
+    std::vector<unsigned> m_positions;      //!< The lines not cached
+    //! The memory of the Expression buffers
+    Arena m_arena;
+    //! The Expression reset to each line, keeping its buffers warm
+    Expression m_expr{std::string_view(), &m_arena};
+
+    std::uint64_t m_accepted = 0;   //!< The connections accepted
+    std::uint64_t m_requests = 0;   //!< The lines evaluated
+    std::uint64_t m_batches = 0;    //!< The batches evaluated
+    Histogram m_latency;            //!< The latency of the requests
+};
+
+#endif
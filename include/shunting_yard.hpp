@@ -0,0 +1,174 @@
+/*!
+ *  @file shunting_yard.hpp
+ *  @brief Shunting Yard Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the Shunting Yard Class header
+ */
+
+#ifndef _shunting_yard_hpp_
+#define _shunting_yard_hpp_
+
+#include "arithmetic.hpp"
+#include "numeric.hpp"
+#include "term.hpp"
+
+/**
+ * @brief Shunting Yard Class
+ *
+ * The conversion of infix terms to postfix and the evaluation of postfix
+ * terms shared by the evaluators (don't need to be instanciated): the
+ * Expression, on its Stacks, and bares::Evaluator, on fixed Stacks on
+ * constant expressions. A Stack only needs isEmpty, push, pop and top (see
+ * Stack).
+ *
+ * The errors are kept on the given id and column, which are left as they
+ * are when a sink fails (it sets its own error).
+ */
+template <typename Policy>
+class BasicShuntingYard {
+ public:
+    typedef typename Policy::value_type value_type;  //!< The numbers type
+    typedef BasicTerm<value_type> Term;              //!< The Term type
+    typedef BasicArithmetic<Policy> Arithmetic;      //!< The operations
+
+    /**
+     * @brief Shunting Yard Constructor
+     *
+     * Delete Constructor
+     */
+    BasicShuntingYard() = delete;
+
+    /**
+     * @brief Shunting Yard Destructor
+     *
+     * Delete Destructor
+     */
+    ~BasicShuntingYard() = delete;
+
+    /**
+     * @brief Send one infix term through the operators Stack
+     * @param _t The infix term
+     * @param _operators The operators Stack
+     * @param _sink The function called with each term, in postfix order
+     * @param _error The var to keep the error id
+     * @param _col The var to keep the error column
+     *
+     * @return True if all succeed, False otherwise
+     */
+    template <typename Stack, typename Sink>
+    static constexpr bool shunt(const Term &_t, Stack &_operators,
+                                Sink &&_sink, int &_error, int &_col) {
+        Term t2;
+        _operators.top(t2);
+        // If is a number or a variable, send to postfix output
+        if (_t.kind == Term::NUMBER || _t.kind == Term::VARIABLE)
+            return _sink(_t);
+        // If isn't a number and the stack is empty or is
+        // an opening parenthesis, send to operators stack
+        if (_operators.isEmpty() || _t.kind == Term::OPENING_PARENTHESIS) {
+            // If the tokenize is right, this never should happen
+            if (_t.kind == Term::CLOSING_PARENTHESIS) {
+                _error = 4;
+                _col = _t.col;
+                return false;
+            }
+            return _operators.push(_t);
+        }
+        // If is a closing parenthesis, send all the operators
+        // until the opening parenthesis to postfix output
+        if (_t.kind == Term::CLOSING_PARENTHESIS) {
+            while (_operators.pop(t2) &&
+                   t2.kind != Term::OPENING_PARENTHESIS)
+                if (!_sink(t2))
+                    return false;
+            // If the tokenize is right, this never should happen
+            if (t2.kind != Term::OPENING_PARENTHESIS) {
+                _error = 4;
+                _col = _t.col;
+                return false;
+            }
+            return true;
+        }
+        // Else, remove all operators who have a minor
+        // precedence and push him to operators stack
+        while (_t.precedence() >= t2.precedence() && !_operators.isEmpty() &&
+               t2.kind != Term::OPENING_PARENTHESIS) {
+            _operators.pop(t2);
+            if (!_sink(t2))
+                return false;
+            _operators.top(t2);
+        }
+        return _operators.push(_t);
+    }
+
+    /**
+     * @brief Flush the operators Stack after the last infix term
+     * @param _operators The operators Stack
+     * @param _sink The function called with each term, in postfix order
+     * @param _error The var to keep the error id
+     * @param _col The var to keep the error column
+     *
+     * @return True if all succeed, False otherwise
+     */
+    template <typename Stack, typename Sink>
+    static constexpr bool shunt_end(Stack &_operators, Sink &&_sink,
+                                    int &_error, int &_col) {
+        Term t2;
+        // Remove remaining terms on Stack
+        while (_operators.pop(t2)) {
+            // If the tokenize is right, this never should happen
+            if (t2.kind == Term::OPENING_PARENTHESIS) {
+                _error = 6;
+                _col = t2.col;
+                return false;
+            }
+            if (!_sink(t2))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Apply one postfix term to the operands
+     * @param _t The postfix term
+     * @param _operands The operands Stack
+     * @param _lhs The last left hand side operand
+     * @param _rhs The last right hand side operand (or result)
+     * @param _error The var to keep the error id
+     * @param _col The var to keep the error column (an operation error has
+     * no column)
+     *
+     * An operator that finds the Stack empty (e.g. on "2%(+3)") reuses the
+     * last operands taken from it, which are kept across the terms.
+     *
+     * @return True if all succeed, False otherwise
+     */
+    template <typename Stack>
+    static constexpr bool reduce(const Term &_t, Stack &_operands, Term &_lhs,
+                                 Term &_rhs, int &_error, int &_col) {
+        // If is a number, push him to the operands Stack
+        if (_t.kind == Term::NUMBER)
+            return _operands.push(_t);
+
+        _operands.pop(_rhs);
+        // If is unary, set the first term as 0
+        if (_t.is_unary)
+            _lhs.value = 0;
+        else
+            _operands.pop(_lhs);
+        // Try to apply operation
+        value_type _result = 0;
+        int _id = -1;
+        if (!Arithmetic::apply(static_cast<int>(_t.value), _lhs.value,
+                               _rhs.value, _result, _id)) {
+            _error = _id;
+            _col = -1;
+            return false;
+        }
+        _rhs.value = _result;
+        return _operands.push(_rhs);
+    }
+};
+
+#endif
@@ -0,0 +1,122 @@
+/*!
+ *  @file spsc_ring.hpp
+ *  @brief SpscRing Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the SpscRing Class header
+ */
+
+#ifndef _spsc_ring_hpp_
+#define _spsc_ring_hpp_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief SpscRing Class
+ *
+ * A bounded ring buffer between a single producer thread and a single
+ * consumer thread. Pushing and popping are lock-free (each side only writes
+ * its own index, on its own cache line); the blocking push and pop spin for
+ * a while and then sleep until the other side makes room or pushes, so a
+ * full ring holds the producer back.
+ */
+template <typename Object>
+class SpscRing {
+ public:
+    /**
+     * @brief SpscRing Constructor
+     * @param _capacity The minimum number of elements (rounded up to a power
+     * of 2)
+     */
+    explicit SpscRing(std::size_t _capacity);
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /**
+     * @brief Insert an element, if there is room (producer only)
+     * @param _x The element
+     * @return True if it was inserted, False if the ring is full
+     */
+    bool try_push(const Object &_x);
+
+    /**
+     * @brief Remove the oldest element, if any (consumer only)
+     * @param _return Keep the element removed
+     * @return True if it was removed, False if the ring is empty
+     */
+    bool try_pop(Object &_return);
+
+    /**
+     * @brief Insert an element, waiting while the ring is full (producer
+     * only)
+     * @param _x The element
+     */
+    void push(const Object &_x);
+
+    /**
+     * @brief Remove the oldest element, waiting while the ring is empty
+     * (consumer only)
+     * @param _return Keep the element removed
+     */
+    void pop(Object &_return);
+
+    /**
+     * @brief Get the capacity
+     * @return The maximum number of elements
+     */
+    std::size_t capacity() const;
+
+ private:
+    //! The size of a cache line (the indexes are kept on different lines)
+    static const std::size_t CACHE_LINE = 64;
+
+    /**
+     * @brief Insert an element, if there is room, without waking the consumer
+     * @param _x The element
+     * @return True if it was inserted, False if the ring is full
+     */
+    bool put(const Object &_x);
+
+    /**
+     * @brief Remove the oldest element, if any, without waking the producer
+     * @param _return Keep the element removed
+     * @return True if it was removed, False if the ring is empty
+     */
+    bool take(Object &_return);
+
+    /**
+     * @brief Wait until a condition holds, sleeping after a few tries
+     * @param _ready The condition (tried without the lock first)
+     */
+    template <typename Condition>
+    void wait(Condition &&_ready);
+
+    /**
+     * @brief Wake up the other side, if it's sleeping
+     */
+    void wake();
+
+    std::vector<Object> m_items;  //!< The elements
+    std::size_t m_mask;           //!< The capacity minus 1
+
+    //! The next position to pop (written by the consumer)
+    alignas(CACHE_LINE) std::atomic<std::size_t> m_head{0};
+    std::size_t m_tail_cache = 0;  //!< The last tail seen by the consumer
+
+    //! The next position to push (written by the producer)
+    alignas(CACHE_LINE) std::atomic<std::size_t> m_tail{0};
+    std::size_t m_head_cache = 0;  //!< The last head seen by the producer
+
+    alignas(CACHE_LINE) std::atomic<unsigned> m_sleepers{0};  //!< Sleeping
+    std::mutex m_mutex;               //!< The sleep mutex
+    std::condition_variable m_wakeup; //!< Wakes up a sleeping side
+};
+
+#include "spsc_ring.inl"
+
+#endif
@@ -0,0 +1,119 @@
+/*!
+ *  @file spsc_ring.inl
+ *  @brief SpscRing Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with SpscRing Class implementations
+ */
+
+#include <thread>
+
+#include "spsc_ring.hpp"
+
+// Constructor
+template <typename Object>
+SpscRing<Object>::SpscRing(std::size_t _capacity) {
+    std::size_t _size = 1;
+    while (_size < _capacity)
+        _size *= 2;
+    m_items.resize(_size);
+    m_mask = _size - 1;
+}
+
+// Try to push an element
+template <typename Object>
+bool SpscRing<Object>::try_push(const Object &_x) {
+    if (!put(_x))
+        return false;
+    wake();
+    return true;
+}
+
+// Try to pop an element
+template <typename Object>
+bool SpscRing<Object>::try_pop(Object &_return) {
+    if (!take(_return))
+        return false;
+    wake();
+    return true;
+}
+
+// Push an element
+template <typename Object>
+void SpscRing<Object>::push(const Object &_x) {
+    wait([this, &_x] { return put(_x); });
+    wake();
+}
+
+// Pop an element
+template <typename Object>
+void SpscRing<Object>::pop(Object &_return) {
+    wait([this, &_return] { return take(_return); });
+    wake();
+}
+
+// Capacity
+template <typename Object>
+std::size_t SpscRing<Object>::capacity() const {
+    return m_items.size();
+}
+
+// Put an element
+template <typename Object>
+bool SpscRing<Object>::put(const Object &_x) {
+    auto _tail = m_tail.load(std::memory_order_relaxed);
+    if (_tail - m_head_cache > m_mask) {
+        m_head_cache = m_head.load(std::memory_order_acquire);
+        if (_tail - m_head_cache > m_mask)
+            return false;
+    }
+    m_items[_tail & m_mask] = _x;
+    m_tail.store(_tail + 1, std::memory_order_release);
+    return true;
+}
+
+// Take an element
+template <typename Object>
+bool SpscRing<Object>::take(Object &_return) {
+    auto _head = m_head.load(std::memory_order_relaxed);
+    if (_head == m_tail_cache) {
+        m_tail_cache = m_tail.load(std::memory_order_acquire);
+        if (_head == m_tail_cache)
+            return false;
+    }
+    _return = m_items[_head & m_mask];
+    m_head.store(_head + 1, std::memory_order_release);
+    return true;
+}
+
+// Wait for a condition
+template <typename Object>
+template <typename Condition>
+void SpscRing<Object>::wait(Condition &&_ready) {
+    // A short wait is cheaper spinning than sleeping
+    for (auto i(0u); i < 64; i++) {
+        if (_ready())
+            return;
+        std::this_thread::yield();
+    }
+
+    // The sleeper is counted before trying again, and the other side
+    // checks the count after moving its index, so one of them sees the
+    // other (and the wake up is sent under the lock, so it isn't lost)
+    std::unique_lock<std::mutex> _lock(m_mutex);
+    m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!_ready())
+        m_wakeup.wait(_lock);
+    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// Wake up the other side
+template <typename Object>
+void SpscRing<Object>::wake() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_relaxed) == 0)
+        return;
+    { std::lock_guard<std::mutex> _lock(m_mutex); }
+    m_wakeup.notify_all();
+}
@@ -9,21 +9,61 @@
 #ifndef _stack_hpp_
 #define _stack_hpp_
 
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+
 /**
  * @brief Stack Class
  *
- * The Stack implementation.
+ * The Stack implementation, on a contiguous buffer that grows geometrically.
+ * The elements are moved (or copied, if they can't be moved safely) to the
+ * new buffer in a single pass, so move-only elements are supported.
+ *
+ * The first N elements are kept inside the Stack itself, so a Stack that
+ * never grows beyond them doesn't allocate memory. The buffer beyond them
+ * comes from the Allocator (e.g. a std::pmr::polymorphic_allocator on an
+ * Arena).
  */
-template <typename Object>
+template <typename Object, unsigned N = 0,
+          typename Allocator = std::allocator<Object>>
 class Stack {
  public:
     /**
      * @brief Stack Constructor
      * @param _sz Receives the initial Stack size
+     * @param _allocator The buffer allocator
+     *
+     * Creates a Stack with _sz size (default = 1, or N if it's greater)
+     */
+    explicit Stack(const unsigned _sz = 1,
+                   const Allocator &_allocator = Allocator());
+
+    /**
+     * @brief Stack Move Constructor
+     * @param _other The Stack to be moved (left empty)
      *
-     * Creates a Stack with _sz size (default = 1)
+     * Doesn't allocate: takes the other buffer, or moves the inline
+     * elements to its own inline buffer
      */
-    explicit Stack(const unsigned _sz = 1);
+    Stack(Stack &&_other) noexcept(
+        std::is_nothrow_move_constructible<Object>::value);
+
+    /**
+     * @brief Stack Move Assignment
+     * @param _other The Stack to be moved (left empty)
+     * @return This Stack
+     *
+     * Only allocates to move the buffer of another (not equal) allocator,
+     * throwing std::bad_alloc if it can't (and then the other Stack is kept)
+     */
+    Stack &operator=(Stack &&_other) noexcept(
+        std::allocator_traits<Allocator>::is_always_equal::value &&
+        std::is_nothrow_move_constructible<Object>::value);
+
+    Stack(const Stack &) = delete;
+    Stack &operator=(const Stack &) = delete;
 
     /**
      * @brief Stack Destructor
@@ -39,26 +79,67 @@ class Stack {
      */
     bool push(const Object &_x);
 
+    /**
+     * @brief Insert an element on Stack
+     * @param _x Receives an element to be moved to the Stack
+     * @return True if the element was successfully added, False otherwise
+     */
+    bool push(Object &&_x);
+
+    /**
+     * @brief Construct an element on top of the Stack
+     * @param _args The element constructor arguments
+     * @return True if the element was successfully added, False otherwise
+     */
+    template <typename... Args>
+    bool emplace(Args &&... _args);
+
     /**
      * @brief Remove an element from Stack
-     * @param _return Keep the removed element
+     * @param _return Keep the removed element (moved from the Stack)
      * @return True if the element was successfully removed, False otherwise
      */
     bool pop(Object &_return);
 
     /**
      * @brief Gets the element on top of Stack
-     * @param _return Keep the top element
+     * @param _return Keep a copy of the top element
      * @return True if the element was successfully accessed, False otherwise
      */
     bool top(Object &_return) const;
 
+    /**
+     * @brief Gets the element on top of Stack
+     * @return A reference to the top element (the Stack must not be empty),
+     * without copying it (e.g. a move-only element)
+     */
+    Object &top();
+
+    /**
+     * @brief Gets the element on top of Stack
+     * @return A reference to the top element (the Stack must not be empty)
+     */
+    const Object &top() const;
+
     /**
      * @brief Get the Stack size
      * @return A unsigned int with the Stack size
      */
     unsigned size() const;
 
+    /**
+     * @brief Get the Stack capacity
+     * @return The number of elements it keeps without growing
+     */
+    unsigned capacity() const;
+
+    /**
+     * @brief Reserve space for elements
+     * @param _sz The number of elements
+     * @return True if the Stack can keep _sz elements, False otherwise
+     */
+    bool reserve(const unsigned _sz);
+
     /**
      * @brief Verify if the Stack is Empty
      * @return True if the Stack is Empty, False if not
@@ -72,7 +153,7 @@ class Stack {
     bool isFull() const;
 
     /**
-     * @brief Make the Stack empty
+     * @brief Make the Stack empty, keeping its capacity
      * @return True if the Stack was successfully empty, False if not
      */
     bool makeEmpty();
@@ -100,8 +181,36 @@ class Stack {
      */
     bool _double();
 
-    int m_top       = 0;        //!< The number of elements on Stack
-    int m_capacity  = 0;        //!< The Stack capacity
+    /**
+     * @brief Move the elements to a new buffer
+     * @param _sz The new buffer capacity
+     * @return True if the buffer was allocated, False otherwise
+     *
+     * An element copy that throws is rethrown, with the Stack as it was
+     */
+    bool _relocate(const unsigned _sz);
+
+    /**
+     * @brief Deallocate the buffer (if it isn't the inline one)
+     */
+    void _deallocate();
+
+    //! The Allocator traits
+    typedef std::allocator_traits<Allocator> Traits;
+
+    /**
+     * @brief Gets the inline buffer
+     * @return A pointer to the first inline element (or null, if N = 0)
+     */
+    Object *_inline() {
+        return N ? reinterpret_cast<Object *>(m_inline) : nullptr;
+    }
+
+    //! The inline buffer, used while the Stack keeps up to N elements
+    alignas(Object) unsigned char m_inline[N ? N * sizeof(Object) : 1];
+    Allocator m_allocator;      //!< The buffer allocator
+    unsigned m_top      = 0;    //!< The number of elements on Stack
+    unsigned m_capacity = 0;    //!< The Stack capacity
     Object *m_stack = nullptr;  //!< A pointer to the first element on memory
 };
 
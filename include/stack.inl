@@ -6,42 +6,110 @@
  *  File with Stack Class implementations
  */
 
+#include <new>
+#include <type_traits>
+#include <utility>
+
 #include "stack.hpp"
 
 // Constructor
-template <typename Object>
-Stack<Object>::Stack(unsigned _sz) {
-    m_stack = new Object[_sz];
-    m_capacity = _sz;
+template <typename Object, unsigned N, typename Allocator>
+Stack<Object, N, Allocator>::Stack(unsigned _sz, const Allocator &_allocator)
+    : m_allocator(_allocator) {
+    m_stack    = _inline();
+    m_capacity = N;
+    reserve(_sz);
+}
+
+// Move Constructor
+template <typename Object, unsigned N, typename Allocator>
+Stack<Object, N, Allocator>::Stack(Stack &&_other) noexcept(
+    std::is_nothrow_move_constructible<Object>::value)
+    : Stack(0, _other.m_allocator) {
+    *this = std::move(_other);
+}
+
+// Move Assignment
+template <typename Object, unsigned N, typename Allocator>
+Stack<Object, N, Allocator> &Stack<Object, N, Allocator>::operator=(
+    Stack &&_other) noexcept(
+        std::allocator_traits<Allocator>::is_always_equal::value &&
+        std::is_nothrow_move_constructible<Object>::value) {
+    if (this == &_other)
+        return *this;
+
+    makeEmpty();
+    if (_other.m_stack != _other._inline() &&
+        m_allocator == _other.m_allocator) {
+        // Take the other buffer
+        _deallocate();
+        m_stack    = _other.m_stack;
+        m_capacity = _other.m_capacity;
+        m_top      = _other.m_top;
+    } else {
+        // The inline elements (or the ones from another allocator) can't be
+        // taken, so move them one by one. The inline ones fit on the inline
+        // buffer (the capacity is never below N), so only the ones from
+        // another allocator may need a buffer
+        if (!reserve(_other.m_top)) {
+            if constexpr (!Traits::is_always_equal::value)
+                throw std::bad_alloc();
+        }
+        for (auto i(0u); i < _other.m_top; i++) {
+            new (m_stack + i) Object(std::move(_other.m_stack[i]));
+            _other.m_stack[i].~Object();
+        }
+        m_top = _other.m_top;
+    }
+    if (_other.m_stack != m_stack)
+        _other._deallocate();
+    _other.m_stack    = _other._inline();
+    _other.m_capacity = N;
+    _other.m_top      = 0;
+    return *this;
 }
 
 // Destructor
-template <typename Object>
-Stack<Object>::~Stack() {
-    delete[] m_stack;
+template <typename Object, unsigned N, typename Allocator>
+Stack<Object, N, Allocator>::~Stack() {
+    makeEmpty();
+    _deallocate();
+}
+
+template <typename Object, unsigned N, typename Allocator>
+bool Stack<Object, N, Allocator>::push(const Object &_x) {
+    return emplace(_x);
 }
 
-template <typename Object>
-bool Stack<Object>::push(const Object &_x) {
+template <typename Object, unsigned N, typename Allocator>
+bool Stack<Object, N, Allocator>::push(Object &&_x) {
+    return emplace(std::move(_x));
+}
+
+template <typename Object, unsigned N, typename Allocator>
+template <typename... Args>
+bool Stack<Object, N, Allocator>::emplace(Args &&... _args) {
     if (isFull())
         if (!_double())
             return false;
 
-    m_stack[m_top++] = _x;
+    new (m_stack + m_top) Object(std::forward<Args>(_args)...);
+    m_top++;
     return true;
 }
 
-template <typename Object>
-bool Stack<Object>::pop(Object &_returned) {
+template <typename Object, unsigned N, typename Allocator>
+bool Stack<Object, N, Allocator>::pop(Object &_returned) {
     if (isEmpty())
         return false;
 
-    _returned = m_stack[--m_top];
+    _returned = std::move(m_stack[--m_top]);
+    m_stack[m_top].~Object();
     return true;
 }
 
-template <typename Object>
-bool Stack<Object>::top(Object &_returned) const {
+template <typename Object, unsigned N, typename Allocator>
+bool Stack<Object, N, Allocator>::top(Object &_returned) const {
     if (isEmpty())
         return false;
 
@@ -49,57 +117,88 @@ bool Stack<Object>::top(Object &_returned) const {
     return true;
 }
 
-template <typename Object>
-unsigned Stack<Object>::size() const {
+template <typename Object, unsigned N, typename Allocator>
+Object &Stack<Object, N, Allocator>::top() {
+    return m_stack[m_top-1];
+}
+
+template <typename Object, unsigned N, typename Allocator>
+const Object &Stack<Object, N, Allocator>::top() const {
+    return m_stack[m_top-1];
+}
+
+template <typename Object, unsigned N, typename Allocator>
+unsigned Stack<Object, N, Allocator>::size() const {
     return m_top;
 }
 
-template <typename Object>
-bool Stack<Object>::isEmpty() const {
+template <typename Object, unsigned N, typename Allocator>
+unsigned Stack<Object, N, Allocator>::capacity() const {
+    return m_capacity;
+}
+
+template <typename Object, unsigned N, typename Allocator>
+bool Stack<Object, N, Allocator>::reserve(const unsigned _sz) {
+    return _sz <= m_capacity || _relocate(_sz);
+}
+
+template <typename Object, unsigned N, typename Allocator>
+bool Stack<Object, N, Allocator>::isEmpty() const {
     return m_top == 0;
 }
 
-template <typename Object>
-bool Stack<Object>::isFull() const {
+template <typename Object, unsigned N, typename Allocator>
+bool Stack<Object, N, Allocator>::isFull() const {
     return m_top == m_capacity;
 }
 
-template <typename Object>
-bool Stack<Object>::makeEmpty() {
-    try {
-        delete[] m_stack;
-        m_stack = new Object;
-    } catch (std::bad_alloc &e) {
-        return false;
-    }
-
-    m_top      = 0;
-    m_capacity = 1;
+template <typename Object, unsigned N, typename Allocator>
+bool Stack<Object, N, Allocator>::makeEmpty() {
+    while (m_top > 0)
+        m_stack[--m_top].~Object();
     return true;
 }
 
 // Double Size
-template <typename Object>
-bool Stack<Object>::_double() {
-    Stack<Object> cpStack(m_capacity);
-    Object aux;
-
-    while (pop(aux))
-        cpStack.push(aux);
-
-    // Delete old Stack array to avoid memory leak
-    delete[] m_stack;
+template <typename Object, unsigned N, typename Allocator>
+bool Stack<Object, N, Allocator>::_double() {
+    return _relocate(m_capacity ? m_capacity * 2 : 1);
+}
 
+// Relocate
+template <typename Object, unsigned N, typename Allocator>
+bool Stack<Object, N, Allocator>::_relocate(const unsigned _sz) {
+    Object *_stack;
     try {
-        m_stack = new Object[m_capacity * 2];
+        _stack = Traits::allocate(m_allocator, _sz);
     } catch (std::bad_alloc &e) {
         return false;
     }
 
-    m_capacity *= 2;
-
-    while (cpStack.pop(aux))
-        push(aux);
+    // Move each element once (copy it if moving may throw), and only then
+    // destroy the old ones, so a copy that throws leaves the Stack as it is
+    auto i(0u);
+    try {
+        for (; i < m_top; i++)
+            new (_stack + i) Object(std::move_if_noexcept(m_stack[i]));
+    } catch (...) {
+        while (i > 0)
+            _stack[--i].~Object();
+        Traits::deallocate(m_allocator, _stack, _sz);
+        throw;
+    }
+    for (i = 0; i < m_top; i++)
+        m_stack[i].~Object();
 
+    _deallocate();
+    m_stack    = _stack;
+    m_capacity = _sz;
     return true;
 }
+
+// Deallocate
+template <typename Object, unsigned N, typename Allocator>
+void Stack<Object, N, Allocator>::_deallocate() {
+    if (m_stack != _inline())
+        Traits::deallocate(m_allocator, m_stack, m_capacity);
+}
@@ -9,51 +9,116 @@
 #ifndef _term_hpp_
 #define _term_hpp_
 
-#include <string>
-#include "queue.hpp"
+#include <ostream>
 
 /**
  * @brief The Term struct
  *
- * The Term struct implementation
+ * The Term struct implementation. A Term is produced once by the tokenizer
+ * and carries the already parsed number (or the operator symbol), so the
+ * remaining phases never need to look at the expression text again.
+ *
+ * The value type T fits the numbers of the evaluator numeric policy.
  */
-struct Term {
-    std::string value = "";  //!< The term value
-    int col = -1;            //!< The term column
-    bool is_unary = false;   //!< Flag to indicate if is a unary operator
+template <typename T>
+struct BasicTerm {
+    /**
+     * @brief The Term kinds
+     */
+    enum Kind : unsigned char {
+        NUMBER,               //!< An integer constant
+        VARIABLE,             //!< A variable (the value is its id)
+        OPERATOR,             //!< A binary or unary operator
+        OPENING_PARENTHESIS,  //!< An opening parenthesis
+        CLOSING_PARENTHESIS   //!< A closing parenthesis
+    };
+
+    T value = 0;            //!< The number, the variable id or the symbol
+    int col = -1;           //!< The term column
+    Kind kind = NUMBER;     //!< The term kind
+    bool is_unary = false;  //!< Flag to indicate if is a unary operator
 
     /**
      * @brief Term Constructor
+     * @param _kind The Term kind (to fit kind variable)
      * @param _val The Term value (to fit value variable)
      * @param _col The Term column (to fit col variable)
      *
      * The Term Constructor function
      */
-    explicit Term(std::string _val = "", int _col = -1) : value(_val), col(_col) {}
+    constexpr explicit BasicTerm(Kind _kind = NUMBER, T _val = 0,
+                                 int _col = -1)
+        : value(_val), col(_col), kind(_kind) {}
 
     /**
      * @brief Term Setter
+     * @param _kind The Term kind (to fit kind variable)
      * @param _val The Term value (to fit value variable)
      * @param _col The Term column (to fit col variable)
      * @param _unr The unary term flag (to fit is_unary variable)
      *
      * The Term Setter function
      */
-    template <typename str>
-    void set(str _val = "", int _col = -1, bool _unr = false) {
+    constexpr void set(Kind _kind, T _val = 0, int _col = -1,
+                       bool _unr = false) {
         value = _val;
         col = _col;
+        kind = _kind;
         is_unary = _unr;
     }
+
+    /**
+     * @brief Gets the Term precedence
+     * @return A integer with the precedence (-1 if isn't an operator or a
+     * parenthesis)
+     *
+     * Gets the precedence using that table (a lower index binds tighter):
+     *
+     * |  Operator  |  Precedence  |
+     * |  :------:  |  :--------:  |
+     * |  ( )       |  1           |
+     * |  - (unary) |  2           |
+     * |  ^         |  3           |
+     * |  / * %     |  4           |
+     * |  + -       |  5           |
+     */
+    constexpr int precedence() const {
+        if (kind == OPENING_PARENTHESIS || kind == CLOSING_PARENTHESIS)
+            return 1;
+        if (kind == OPERATOR) {
+            if (value == '-' && is_unary)
+                return 2;
+            switch (value) {
+                case '^':
+                    return 3;
+                case '*':
+                case '/':
+                case '%':
+                    return 4;
+                case '+':
+                case '-':
+                    return 5;
+            }
+        }
+        return -1;
+    }
 };
 
+//! The Term of the default (16-bit) evaluator
+typedef BasicTerm<int> Term;
+
 /**
  * @brief Overload << operator to Terms
  * @param _os The std::ostream
  * @param _term The Term to be showed
  */
-inline std::ostream &operator<<(std::ostream &_os, const Term &_term) {
-    return _os << "\"" << _term.value << "\"";
+template <typename T>
+std::ostream &operator<<(std::ostream &_os, const BasicTerm<T> &_term) {
+    if (_term.kind == BasicTerm<T>::NUMBER)
+        return _os << "\"" << _term.value << "\"";
+    if (_term.kind == BasicTerm<T>::VARIABLE)
+        return _os << "\"$" << _term.value << "\"";
+    return _os << "\"" << static_cast<char>(_term.value) << "\"";
 }
 
 #endif
@@ -0,0 +1,96 @@
+/*!
+ *  @file thread_pool.hpp
+ *  @brief ThreadPool Class Header
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the ThreadPool Class header
+ */
+
+#ifndef _thread_pool_hpp_
+#define _thread_pool_hpp_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief ThreadPool Class
+ *
+ * A work-stealing pool: each worker has its own tasks deque, takes tasks
+ * from its front and, when it's empty, steals from the back of the others.
+ * So the tasks of a worker run in the order they were submitted, and the
+ * oldest tasks (e.g. the chunk whose results are written next) aren't left
+ * behind the newer ones.
+ */
+class ThreadPool {
+ public:
+    /**
+     * @brief The task type (receives the id of the worker running it)
+     */
+    typedef std::function<void(unsigned)> Task;
+
+    /**
+     * @brief ThreadPool Constructor
+     * @param _threads The number of workers (at least 1)
+     *
+     * Creates the pool and starts all workers
+     */
+    explicit ThreadPool(unsigned _threads);
+
+    /**
+     * @brief ThreadPool Destructor
+     *
+     * Runs the remaining tasks and joins all workers
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Submit a task to the pool
+     * @param _task The task to be run
+     */
+    void submit(Task _task);
+
+    /**
+     * @brief Get the number of workers
+     * @return The number of workers
+     */
+    unsigned size() const;
+
+ private:
+    /**
+     * @brief The Worker struct
+     */
+    struct Worker {
+        std::mutex mutex;        //!< The tasks deque mutex
+        std::deque<Task> tasks;  //!< The tasks deque
+    };
+
+    /**
+     * @brief Take a task, stealing it from another worker if needed
+     * @param _worker The id of the worker taking the task
+     * @param _return Keep the task taken
+     * @return True if a task was taken, False otherwise
+     */
+    bool take(unsigned _worker, Task &_return);
+
+    /**
+     * @brief The worker loop
+     * @param _worker The worker id
+     */
+    void work(unsigned _worker);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;  //!< The workers deques
+    std::vector<std::thread> m_threads;              //!< The workers threads
+    std::mutex m_mutex;                  //!< The pending count mutex
+    std::condition_variable m_wakeup;    //!< Wakes up the idle workers
+    unsigned m_pending = 0;              //!< The number of queued tasks
+    bool m_stop = false;                 //!< Flag to finish the workers
+    std::atomic<unsigned> m_next{0};     //!< The next worker to submit to
+};
+
+#endif
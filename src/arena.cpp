@@ -0,0 +1,83 @@
+/*!
+ *  @file arena.cpp
+ *  @brief Arena Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with Arena Class implementations
+ */
+
+#include <cstdint>
+#include <new>
+
+#include "arena.hpp"
+
+// Constructor
+Arena::Arena(std::size_t _block_size) : m_block_size(_block_size) {}
+
+// Destructor
+Arena::~Arena() {
+    while (m_first != nullptr) {
+        Block *_next = m_first->next;
+        ::operator delete(m_first);
+        m_first = _next;
+    }
+}
+
+// Reset
+void Arena::reset() {
+    if (m_first != nullptr)
+        use(m_first);
+}
+
+// Blocks
+std::size_t Arena::blocks() const {
+    return m_blocks;
+}
+
+// Allocate
+void *Arena::do_allocate(std::size_t _bytes, std::size_t _align) {
+    while (true) {
+        auto _addr = reinterpret_cast<std::uintptr_t>(m_pos);
+        auto _aligned = (_addr + _align - 1) & ~(std::uintptr_t(_align) - 1);
+        char *_p = m_pos + (_aligned - _addr);
+        if (m_pos != nullptr && _p + _bytes <= m_end) {
+            m_pos = _p + _bytes;
+            return _p;
+        }
+
+        // Go to the next block kept from before a reset, if it fits there
+        Block *_next = m_current ? m_current->next : nullptr;
+        if (_next != nullptr && _next->size >= _bytes + _align) {
+            use(_next);
+            continue;
+        }
+
+        // Else, insert a new block after the current one
+        std::size_t _size = m_block_size;
+        if (_size < _bytes + _align)
+            _size = _bytes + _align;
+        Block *_block = static_cast<Block *>(
+            ::operator new(sizeof(Block) + _size));
+        _block->size = _size;
+        _block->next = _next;
+        if (m_current != nullptr)
+            m_current->next = _block;
+        else
+            m_first = _block;
+        m_blocks++;
+        use(_block);
+    }
+}
+
+// Compare
+bool Arena::do_is_equal(const std::pmr::memory_resource &_other) const
+    noexcept {
+    return this == &_other;
+}
+
+// Use a block
+void Arena::use(Block *_block) {
+    m_current = _block;
+    m_pos     = reinterpret_cast<char *>(_block + 1);
+    m_end     = m_pos + _block->size;
+}
@@ -0,0 +1,212 @@
+/*!
+ *  @file driver.cpp
+ *  @brief Driver Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with Driver Class implementations
+ */
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "driver.hpp"
+#include "expression.hpp"
+#include "thread_pool.hpp"
+
+// Lines by chunk
+static const unsigned CHUNK_LINES = 4096;
+// Chunks being evaluated or waiting to be written, by thread
+static const unsigned CHUNKS_BY_THREAD = 4;
+
+// Constructor
+Driver::Driver(unsigned _threads, ResultCache *_cache, bool _share,
+               Profiler *_profiler)
+    : m_threads(_threads), m_cache(_cache), m_share(_share),
+      m_profiler(_profiler) {
+    if (m_threads == 0)
+        m_threads = std::thread::hardware_concurrency();
+    if (m_threads == 0)
+        m_threads = 1;
+    // The states aren't movable (see Arena), so they're built in place
+    std::vector<State>(m_threads).swap(m_states);
+    for (auto &_state : m_states)
+        recycle(_state);
+}
+
+// Run
+bool Driver::run(Input &_input, Output &_output) {
+    std::string_view line;
+
+    // The lines evaluated one by one release their memory by chunks too
+    if (m_profiler != nullptr) {
+        for (auto i(1u); _input.next(line); i++) {
+            if (i % CHUNK_LINES == 0)
+                recycle(m_states[0]);
+            calculate(line, m_states[0].result, m_states[0]);
+            m_profiler->start(Profiler::OUTPUT);
+            _output.write(m_states[0].result);
+            m_profiler->stop(Profiler::OUTPUT);
+        }
+        m_profiler->start(Profiler::OUTPUT);
+        bool _flushed = _output.flush();
+        m_profiler->stop(Profiler::OUTPUT);
+        return _flushed;
+    }
+
+    if (m_threads == 1 && !m_share) {
+        for (auto i(1u); _input.next(line); i++) {
+            if (i % CHUNK_LINES == 0)
+                recycle(m_states[0]);
+            calculate(line, m_states[0].result, m_states[0]);
+            _output.write(m_states[0].result);
+        }
+        return _output.flush();
+    }
+
+    if (m_threads == 1) {
+        bool _more;
+        do {
+            Chunk _chunk;
+            _more = read(_input, _chunk);
+            evaluate(_chunk, m_states[0]);
+            _output.write(_chunk.output);
+        } while (_more);
+        return _output.flush();
+    }
+
+    ThreadPool pool(m_threads);
+    std::deque<std::unique_ptr<Chunk>> chunks;
+    bool _eof = false;
+
+    while (!_eof || !chunks.empty()) {
+        // Keep the pool busy with the next chunks
+        while (!_eof && chunks.size() < m_threads * CHUNKS_BY_THREAD) {
+            std::unique_ptr<Chunk> _chunk(new Chunk);
+            _eof = !read(_input, *_chunk);
+            if (_chunk->lines.empty())
+                break;
+            Chunk *_c = _chunk.get();
+            pool.submit([this, _c](unsigned _worker) {
+                evaluate(*_c, m_states[_worker]);
+            });
+            chunks.push_back(std::move(_chunk));
+        }
+        if (chunks.empty())
+            break;
+
+        // Write the oldest chunk as soon as it's evaluated
+        {
+            std::unique_lock<std::mutex> _lock(m_mutex);
+            m_done.wait(_lock, [&chunks] { return chunks.front()->done; });
+        }
+        _output.write(chunks.front()->output);
+        chunks.pop_front();
+    }
+
+    return _output.flush();
+}
+
+// Threads
+unsigned Driver::threads() const {
+    return m_threads;
+}
+
+// Read a chunk
+bool Driver::read(Input &_input, Chunk &_chunk) {
+    std::string_view line;
+    if (_input.is_stable()) {
+        // The lines are views of the input, so they aren't copied
+        _chunk.lines.reserve(CHUNK_LINES);
+        while (_chunk.lines.size() < CHUNK_LINES && _input.next(line))
+            _chunk.lines.push_back(line);
+    } else {
+        // Copy the lines to a single text, since they're only valid
+        // until the next line is read
+        m_lengths.clear();
+        while (m_lengths.size() < CHUNK_LINES && _input.next(line)) {
+            _chunk.text.append(line);
+            m_lengths.push_back(line.size());
+        }
+        const char *_begin = _chunk.text.data();
+        _chunk.lines.reserve(m_lengths.size());
+        for (auto _length : m_lengths) {
+            _chunk.lines.emplace_back(_begin, _length);
+            _begin += _length;
+        }
+    }
+    return _chunk.lines.size() == CHUNK_LINES;
+}
+
+// Recycle a worker memory
+void Driver::recycle(State &_state) {
+    _state.expr.reset();
+    _state.arena.reset();
+    _state.expr.emplace(std::string_view(), &_state.arena);
+}
+
+// Evaluate a line
+void Driver::calculate(std::string_view _expr, Result &_return,
+                       State &_state) {
+    if (m_cache != nullptr && m_cache->find(_expr, _return))
+        return;
+    _state.expr->reset(_expr);
+    if (m_profiler != nullptr)
+        _state.expr->calculate(_return, *m_profiler);
+    else
+        _state.expr->calculate(_return);
+    if (m_cache != nullptr)
+        m_cache->insert(_expr, _return);
+}
+
+// Evaluate a chunk
+void Driver::evaluate(Chunk &_chunk, State &_state) {
+    char _line[Output::MAX_LINE];
+    recycle(_state);
+    if (m_share) {
+        evaluate_batch(_chunk, _state);
+        for (const auto &_result : _state.results)
+            _chunk.output.append(_line, Output::format(_result, _line));
+    } else {
+        for (const auto &_expr : _chunk.lines) {
+            calculate(_expr, _state.result, _state);
+            _chunk.output.append(_line, Output::format(_state.result, _line));
+        }
+    }
+    _chunk.lines.clear();
+    _chunk.text.clear();
+
+    {
+        std::lock_guard<std::mutex> _lock(m_mutex);
+        _chunk.done = true;
+    }
+    m_done.notify_all();
+}
+
+// Evaluate a chunk as a batch
+void Driver::evaluate_batch(Chunk &_chunk, State &_state) {
+    _state.results.resize(_chunk.lines.size());
+    _state.batch.clear();
+    _state.positions.clear();
+
+    // Only the lines not cached are evaluated, all together
+    for (auto i(0u); i < _chunk.lines.size(); i++) {
+        if (m_cache != nullptr && m_cache->find(_chunk.lines[i],
+                                                _state.results[i]))
+            continue;
+        _state.batch.push_back(_chunk.lines[i]);
+        _state.positions.push_back(i);
+    }
+    Expression::calculate_batch(_state.batch, _state.batch_results,
+                                &_state.arena);
+
+    for (auto i(0u); i < _state.positions.size(); i++) {
+        _state.results[_state.positions[i]] = _state.batch_results[i];
+        if (m_cache != nullptr)
+            m_cache->insert(_state.batch[i], _state.batch_results[i]);
+    }
+}
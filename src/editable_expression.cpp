@@ -0,0 +1,1097 @@
+/*!
+ *  @file editable_expression.cpp
+ *  @brief Editable Expression Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with Editable Expression Class implementations
+ */
+
+#include <algorithm>
+#include <climits>
+#include <tuple>
+#include <utility>
+
+#include "editable_expression.hpp"
+
+/**
+ * @brief The Token struct
+ *
+ * A number (all its digits) or a single character, with the whitespaces
+ * before it
+ */
+struct EditableExpression::Token {
+    LexerTable::Class kind;  //!< The class of the first character
+    char symbol;             //!< The first character
+    bool unary;              //!< Flag to indicate a unary minus
+    bool quirk;              //!< Flag to indicate a juxtaposition
+    int error;               //!< The syntax error on it (-1 if there is none)
+    int value;               //!< The number value
+    unsigned spaces;         //!< The whitespaces before it
+    unsigned length;         //!< The number of characters
+    State after;             //!< The Lexer state after it
+
+    /**
+     * @brief Get the depth change
+     * @return 1 to an opening parenthesis, -1 to a closing one, or 0
+     */
+    int depth() const {
+        return kind == LexerTable::OPENING ? 1
+                                           : kind == LexerTable::CLOSING ? -1
+                                                                         : 0;
+    }
+};
+
+/**
+ * @brief A node of the tokens tree (on the tokens order)
+ */
+struct EditableExpression::TokenNode {
+    Token token;                //!< The token
+    TokenNode *left = nullptr;  //!< The tokens before it
+    TokenNode *right = nullptr; //!< The tokens after it
+    std::uint32_t priority;     //!< The priority (greater on the root)
+    unsigned count;             //!< The tokens on the subtree
+    std::size_t chars;          //!< The characters on the subtree
+    unsigned errors;            //!< The tokens with a syntax error
+    unsigned quirks;            //!< The juxtapositions
+    int depth;                  //!< The parentheses opened and not closed
+    int lowest;                 //!< The lowest depth after a token
+    int lowest_opening;         //!< The lowest depth before an opening one
+
+    /**
+     * @brief Update the subtree values from the children
+     */
+    void update();
+};
+
+/**
+ * @brief An item of a term (an operand or an operator)
+ */
+struct EditableExpression::Item {
+    /**
+     * @brief The kinds of items
+     */
+    enum Kind { NUMBER, OPERATOR, NEGATE, GROUP };
+
+    Kind kind;              //!< The kind
+    int value;              //!< The number or the operator symbol
+    Group *group = nullptr; //!< The parenthesized group (owned)
+};
+
+/**
+ * @brief A term of a sum (the powers and products between two binary '+'
+ * or '-', with the one before it)
+ */
+struct EditableExpression::Term {
+    std::vector<Item> items;  //!< The items (in infix order)
+    char sign = 0;            //!< The operator before it (0 on the first)
+    unsigned tokens = 0;      //!< The tokens (with the operator before it)
+    Result result;            //!< The value or the first error
+
+    /**
+     * @brief Evaluate the items (the groups are already evaluated)
+     *
+     * In the same order of the postfix evaluation, so the first error is the
+     * same
+     */
+    void evaluate();
+};
+
+/**
+ * @brief A node of the terms tree of a group (on the terms order)
+ */
+struct EditableExpression::TermNode {
+    Term term;                   //!< The term
+    TermNode *left = nullptr;    //!< The terms before it
+    TermNode *right = nullptr;   //!< The terms after it
+    TermNode *parent = nullptr;  //!< The parent node (null on the root)
+    std::uint32_t priority;      //!< The priority (greater on the root)
+    unsigned count;              //!< The terms on the subtree
+    unsigned tokens;             //!< The tokens on the subtree
+    unsigned errors;             //!< The terms with an error
+    long sum;                    //!< The sum of the terms
+    long lowest;                 //!< The lowest partial sum
+    long highest;                //!< The highest partial sum
+
+    /**
+     * @brief Get the term value on the sum
+     * @return The value (0 if it's an error)
+     */
+    long value() const {
+        if (term.result.is_error())
+            return 0;
+        return term.sign == '-' ? -long(term.result.value) : term.result.value;
+    }
+
+    /**
+     * @brief Update the subtree values from the children
+     */
+    void update();
+};
+
+/**
+ * @brief A parenthesized group (or the whole text)
+ */
+struct EditableExpression::Group {
+    TermNode *terms = nullptr;  //!< The terms tree
+    TermNode *owner = nullptr;  //!< The term with it (null on the whole text)
+    Group *parent = nullptr;    //!< The group around it
+    Result result;              //!< The value or the first error
+
+    /**
+     * @brief Get the number of tokens
+     * @return The tokens of the terms and of the parentheses
+     */
+    unsigned tokens() const {
+        return (terms != nullptr ? terms->tokens : 0) +
+               (parent != nullptr ? 2 : 0);
+    }
+
+    /**
+     * @brief Evaluate the sum of the terms
+     *
+     * The first error is the first term error or partial sum out of range,
+     * found through the subtrees with an error or a partial sum out of range
+     */
+    void evaluate();
+};
+
+/**
+ * @brief Get the number of nodes of a tree
+ * @param _node The tree root (or null)
+ * @return The number of nodes
+ */
+template <typename Node>
+static unsigned count_of(const Node *_node) {
+    return _node != nullptr ? _node->count : 0;
+}
+
+/**
+ * @brief Split a tree by the nodes order
+ * @param _node The tree root (or null)
+ * @param _k The number of nodes on the left tree
+ * @param _left Keep the first _k nodes
+ * @param _right Keep the other nodes
+ */
+template <typename Node>
+static void split(Node *_node, unsigned _k, Node *&_left, Node *&_right) {
+    if (_node == nullptr) {
+        _left = _right = nullptr;
+        return;
+    }
+    if (count_of(_node->left) < _k) {
+        split(_node->right, _k - count_of(_node->left) - 1, _node->right,
+              _right);
+        _left = _node;
+    } else {
+        split(_node->left, _k, _left, _node->left);
+        _right = _node;
+    }
+    _node->update();
+}
+
+/**
+ * @brief Join two trees
+ * @param _left The first nodes (or null)
+ * @param _right The last nodes (or null)
+ * @return The tree root
+ */
+template <typename Node>
+static Node *merge(Node *_left, Node *_right) {
+    if (_left == nullptr)
+        return _right;
+    if (_right == nullptr)
+        return _left;
+    if (_left->priority > _right->priority) {
+        _left->right = merge(_left->right, _right);
+        _left->update();
+        return _left;
+    }
+    _right->left = merge(_left, _right->left);
+    _right->update();
+    return _right;
+}
+
+/**
+ * @brief Update the values of a whole tree
+ * @param _node The tree root (or null)
+ */
+template <typename Node>
+static void update_all(Node *_node) {
+    if (_node == nullptr)
+        return;
+    update_all(_node->left);
+    update_all(_node->right);
+    _node->update();
+}
+
+/**
+ * @brief Build a tree from its nodes, in linear time
+ * @param _nodes The nodes (in order, with the priorities)
+ * @return The tree root (or null)
+ */
+template <typename Node>
+static Node *build(const std::vector<Node *> &_nodes) {
+    // The right spine of the tree, with the priorities decreasing
+    std::vector<Node *> _spine;
+    for (Node *_node : _nodes) {
+        Node *_last = nullptr;
+        while (!_spine.empty() && _spine.back()->priority < _node->priority) {
+            _last = _spine.back();
+            _spine.pop_back();
+        }
+        _node->left = _last;
+        _node->right = nullptr;
+        if (!_spine.empty())
+            _spine.back()->right = _node;
+        _spine.push_back(_node);
+    }
+    if (_spine.empty())
+        return nullptr;
+    update_all(_spine.front());
+    return _spine.front();
+}
+
+/**
+ * @brief Get the k-th node of a tree
+ * @param _node The tree root
+ * @param _k The node position (less than the number of nodes)
+ * @return The node
+ */
+template <typename Node>
+static Node *nth(Node *_node, unsigned _k) {
+    while (count_of(_node->left) != _k) {
+        if (_k < count_of(_node->left)) {
+            _node = _node->left;
+        } else {
+            _k -= count_of(_node->left) + 1;
+            _node = _node->right;
+        }
+    }
+    return _node;
+}
+
+/**
+ * @brief Delete a tokens tree
+ * @param _node The tree root (or null)
+ */
+template <typename Node>
+static void destroy_tokens(Node *_node) {
+    if (_node == nullptr)
+        return;
+    destroy_tokens(_node->left);
+    destroy_tokens(_node->right);
+    delete _node;
+}
+
+/**
+ * @brief Find the token on a position of the text
+ * @param _node The tokens tree root (or null)
+ * @param _pos The position
+ * @return The index of the token with the position (on it or on the
+ * whitespaces before it), or the number of tokens if it's after all tokens
+ */
+template <typename Node>
+static unsigned token_at(const Node *_node, std::size_t _pos) {
+    unsigned _index = 0;
+    while (_node != nullptr) {
+        std::size_t _before = _node->left != nullptr ? _node->left->chars : 0;
+        if (_pos < _before) {
+            _node = _node->left;
+            continue;
+        }
+        _pos -= _before;
+        _index += count_of(_node->left);
+        std::size_t _own = _node->token.spaces + _node->token.length;
+        if (_pos < _own)
+            return _index;
+        _pos -= _own;
+        _index++;
+        _node = _node->right;
+    }
+    return _index;
+}
+
+/**
+ * @brief Get the position of a token
+ * @param _node The tokens tree root (or null)
+ * @param _k The token index (or the number of tokens)
+ * @return The position of the whitespaces before it (or of the text after
+ * the last token)
+ */
+template <typename Node>
+static std::size_t chars_before(const Node *_node, unsigned _k) {
+    std::size_t _chars = 0;
+    while (_node != nullptr) {
+        if (_k < count_of(_node->left)) {
+            _node = _node->left;
+            continue;
+        }
+        if (_node->left != nullptr)
+            _chars += _node->left->chars;
+        if (_k == count_of(_node->left))
+            break;
+        _chars += _node->token.spaces + _node->token.length;
+        _k -= count_of(_node->left) + 1;
+        _node = _node->right;
+    }
+    return _chars;
+}
+
+/**
+ * @brief Copy a range of tokens
+ * @param _node The tokens subtree root (or null)
+ * @param _begin The index of the first token
+ * @param _end The index after the last token
+ * @param _base The index of the first token of the subtree
+ * @param _return Keep the tokens
+ */
+template <typename Node, typename Token>
+static void collect(const Node *_node, unsigned _begin, unsigned _end,
+                    unsigned _base, std::vector<Token> &_return) {
+    if (_node == nullptr || _begin >= _base + _node->count || _end <= _base)
+        return;
+    unsigned _index = _base + count_of(_node->left);
+    collect(_node->left, _begin, _end, _base, _return);
+    if (_begin <= _index && _index < _end)
+        _return.push_back(_node->token);
+    collect(_node->right, _begin, _end, _index + 1, _return);
+}
+
+/**
+ * @brief Find the term with a token
+ * @param _node The terms tree root
+ * @param _token The token index (on the group)
+ * @param _index Keep the term index
+ * @param _start Keep the index of the first token of the term
+ * @return The term node
+ */
+template <typename Node>
+static Node *term_at(Node *_node, unsigned _token, unsigned &_index,
+                     unsigned &_start) {
+    _index = _start = 0;
+    while (true) {
+        unsigned _before = _node->left != nullptr ? _node->left->tokens : 0;
+        if (_token < _before) {
+            _node = _node->left;
+            continue;
+        }
+        _token -= _before;
+        _index += count_of(_node->left);
+        _start += _before;
+        if (_token < _node->term.tokens || _node->right == nullptr)
+            return _node;
+        _token -= _node->term.tokens;
+        _start += _node->term.tokens;
+        _index++;
+        _node = _node->right;
+    }
+}
+
+/**
+ * @brief Get the number of tokens before a term
+ * @param _node The terms tree root (or null)
+ * @param _k The term index (or the number of terms)
+ * @return The number of tokens
+ */
+template <typename Node>
+static unsigned tokens_before(const Node *_node, unsigned _k) {
+    unsigned _tokens = 0;
+    while (_node != nullptr) {
+        if (_k < count_of(_node->left)) {
+            _node = _node->left;
+            continue;
+        }
+        if (_node->left != nullptr)
+            _tokens += _node->left->tokens;
+        if (_k == count_of(_node->left))
+            break;
+        _tokens += _node->term.tokens;
+        _k -= count_of(_node->left) + 1;
+        _node = _node->right;
+    }
+    return _tokens;
+}
+
+/**
+ * @brief Delete a terms tree, with all groups on it
+ * @param _node The tree root (or null)
+ */
+template <typename Node>
+static void destroy_terms(Node *_node) {
+    // Without recursion, as the groups may be deeply nested
+    std::vector<Node *> _nodes;
+    if (_node != nullptr)
+        _nodes.push_back(_node);
+    while (!_nodes.empty()) {
+        _node = _nodes.back();
+        _nodes.pop_back();
+        if (_node->left != nullptr)
+            _nodes.push_back(_node->left);
+        if (_node->right != nullptr)
+            _nodes.push_back(_node->right);
+        for (auto &_item : _node->term.items) {
+            if (_item.group == nullptr)
+                continue;
+            if (_item.group->terms != nullptr)
+                _nodes.push_back(_item.group->terms);
+            delete _item.group;
+        }
+        delete _node;
+    }
+}
+
+// Update the token subtree
+void EditableExpression::TokenNode::update() {
+    int _depth = token.depth();
+    int _before = left != nullptr ? left->depth : 0;
+    count = 1 + count_of(left) + count_of(right);
+    chars = token.spaces + token.length;
+    errors = token.error >= 0;
+    quirks = token.quirk;
+    lowest = _before + _depth;
+    lowest_opening = token.kind == LexerTable::OPENING ? _before : INT_MAX;
+    if (left != nullptr) {
+        chars += left->chars;
+        errors += left->errors;
+        quirks += left->quirks;
+        lowest = std::min(lowest, left->lowest);
+        lowest_opening = std::min(lowest_opening, left->lowest_opening);
+    }
+    depth = _before + _depth;
+    if (right != nullptr) {
+        chars += right->chars;
+        errors += right->errors;
+        quirks += right->quirks;
+        lowest = std::min(lowest, depth + right->lowest);
+        if (right->lowest_opening != INT_MAX)
+            lowest_opening =
+                std::min(lowest_opening, depth + right->lowest_opening);
+        depth += right->depth;
+    }
+}
+
+// Update the term subtree
+void EditableExpression::TermNode::update() {
+    long _value = value();
+    count = 1 + count_of(left) + count_of(right);
+    tokens = term.tokens;
+    errors = term.result.is_error();
+    sum = lowest = highest = _value;
+    if (left != nullptr) {
+        left->parent = this;
+        tokens += left->tokens;
+        errors += left->errors;
+        sum = left->sum + _value;
+        lowest = std::min(left->lowest, sum);
+        highest = std::max(left->highest, sum);
+    }
+    if (right != nullptr) {
+        right->parent = this;
+        tokens += right->tokens;
+        errors += right->errors;
+        lowest = std::min(lowest, sum + right->lowest);
+        highest = std::max(highest, sum + right->highest);
+        sum += right->sum;
+    }
+}
+
+// Evaluate a term
+void EditableExpression::Term::evaluate() {
+    result = Result();
+    int _product = 0, _power = 0;
+    int _op = 0;  // The '*', '/' or '%' waiting for the power after it
+    bool _raise = false, _negate = false;
+
+    for (const auto &_item : items) {
+        int _value = _item.value;
+        switch (_item.kind) {
+            case Item::NEGATE:
+                _negate = true;
+                continue;
+            case Item::OPERATOR:
+                if (_item.value == '^') {
+                    _raise = true;
+                    continue;
+                }
+                // The power before the operator is complete
+                if (_op != 0 && !Arithmetic::apply(_op, _product, _power,
+                                                   _product, result.error))
+                    return;
+                if (_op == 0)
+                    _product = _power;
+                _op = _item.value;
+                continue;
+            case Item::GROUP:
+                if (_item.group->result.is_error()) {
+                    result.error = _item.group->result.error;
+                    return;
+                }
+                _value = _item.group->result.value;
+                break;
+            case Item::NUMBER:
+                break;
+        }
+        // The unary minus binds tighter than the power
+        if (_negate && !Arithmetic::apply('-', 0, _value, _value, result.error))
+            return;
+        if (_raise && !Arithmetic::apply('^', _power, _value, _power,
+                                         result.error))
+            return;
+        if (!_raise)
+            _power = _value;
+        _negate = _raise = false;
+    }
+    if (_op != 0 &&
+        !Arithmetic::apply(_op, _product, _power, _product, result.error))
+        return;
+    result.value = _op != 0 ? _product : _power;
+}
+
+// Evaluate a group
+void EditableExpression::Group::evaluate() {
+    result = Result();
+    // The partial sum before the subtree
+    long _sum = 0;
+    TermNode *_node = terms;
+    while (_node != nullptr) {
+        // The first error is on the left subtree, if it has any
+        TermNode *_left = _node->left;
+        if (_left != nullptr &&
+            (_left->errors > 0 || _sum + _left->lowest < Int16::min ||
+             _sum + _left->highest > Int16::max)) {
+            _node = _left;
+            continue;
+        }
+        if (_left != nullptr)
+            _sum += _left->sum;
+        if (_node->term.result.is_error()) {
+            result.error = _node->term.result.error;
+            return;
+        }
+        _sum += _node->value();
+        if (_sum < Int16::min || _sum > Int16::max) {
+            result.error = 8;
+            return;
+        }
+        _node = _node->right;
+    }
+    result.value = terms != nullptr ? terms->sum : 0;
+}
+
+// Constructor
+EditableExpression::EditableExpression(std::string_view _expr) {
+    reset(_expr);
+}
+
+// Destructor
+EditableExpression::~EditableExpression() {
+    destroy_tokens(m_tokens);
+    if (m_root != nullptr)
+        destroy_terms(m_root->terms);
+    delete m_root;
+}
+
+// Replace the text
+void EditableExpression::reset(std::string_view _expr) {
+    destroy_tokens(m_tokens);
+    m_tokens = nullptr;
+    if (m_root != nullptr)
+        destroy_terms(m_root->terms);
+    delete m_root;
+    m_root = nullptr;
+    m_dirty = false;
+    m_text.clear();
+    edit(0, 0, _expr);
+}
+
+// Edit the text
+bool EditableExpression::edit(std::size_t _offset, std::size_t _removed,
+                              std::string_view _inserted) {
+    if (_offset > m_text.size() || _removed > m_text.size() - _offset)
+        return false;
+
+    // Read again from the token before the edit (a number may be joined to
+    // it), with the Lexer state after the token before that one
+    unsigned _count = count_of(m_tokens);
+    unsigned _begin = token_at(m_tokens, _offset);
+    if (_begin > 0)
+        _begin--;
+    std::size_t _pos = chars_before(m_tokens, _begin);
+    State _state = _begin > 0 ? nth(m_tokens, _begin - 1)->token.after
+                              : State();
+    long _delta = long(_inserted.size()) - long(_removed);
+    std::size_t _edited = _offset + _inserted.size();
+    m_text.replace(_offset, _removed, _inserted);
+
+    // Until a token after the edit starts on the same place with the same
+    // Lexer state before it (so it and all after it are the same)
+    std::vector<TokenNode *> _fresh;
+    unsigned _end = _count;
+    while (true) {
+        std::size_t _spaces = _pos;
+        while (_pos < m_text.size() && m_text[_pos] == ' ')
+            _pos++;
+        if (_pos == m_text.size())
+            break;
+        auto _node = new TokenNode;
+        read_token(_pos, _pos - _spaces, _state, _node->token);
+        _node->priority = priority();
+        _fresh.push_back(_node);
+        _pos += _node->token.length;
+        _state = _node->token.after;
+        if (_pos < _edited)
+            continue;
+
+        std::size_t _old = _pos - _delta;
+        unsigned k = token_at(m_tokens, _old);
+        if (k == _count || chars_before(m_tokens, k) != _old)
+            continue;
+        State _before = k > 0 ? nth(m_tokens, k - 1)->token.after : State();
+        if (_before.state == _state.state && _before.unary == _state.unary) {
+            _end = k;
+            break;
+        }
+    }
+
+    TokenNode *_left, *_middle, *_right;
+    split(m_tokens, _end, _middle, _right);
+    split(_middle, _begin, _left, _middle);
+    destroy_tokens(_middle);
+    m_tokens = merge(merge(_left, build(_fresh)), _right);
+    touch(_begin, _end, _fresh.size());
+    return true;
+}
+
+// Read a token
+void EditableExpression::read_token(std::size_t _pos, std::size_t _spaces,
+                                    const State &_state,
+                                    Token &_return) const {
+    typedef LexerTable Table;
+    // The whitespaces only change the state
+    Table::State _before = _spaces > 0
+        ? Table::transitions[_state.state][Table::SPACE].next
+        : _state.state;
+    const char c = m_text[_pos];
+    Table::Class _class = Table::classes[static_cast<unsigned char>(c)];
+    if (_class == Table::VARIABLE)
+        _class = Table::INVALID;
+    const Table::Transition &_next = Table::transitions[_before][_class];
+
+    _return.kind = _class;
+    _return.symbol = c;
+    _return.unary = _next.action == Table::UNARY_OPERATOR;
+    _return.error = _next.error;
+    _return.value = c - '0';
+    _return.spaces = _spaces;
+    _return.length = 1;
+    _return.after = {_next.next, _return.unary};
+    // A parenthesis after an operand, an operator after a parenthesis or two
+    // unary minus are valid, but evaluated on their own way
+    _return.quirk =
+        (_next.action == Table::OPEN_GROUP && _next.emit) ||
+        (_next.action == Table::BINARY_OPERATOR &&
+         (_before == Table::AFTER_OPENING ||
+          _before == Table::AFTER_OPENING_SPACE)) ||
+        (_return.unary && _state.unary);
+
+    if (_class != Table::DIGIT)
+        return;
+    // The other digits, with the range verified as the Lexer does
+    unsigned _digits = 1;
+    while (_pos + _return.length < m_text.size() &&
+           Table::classes[static_cast<unsigned char>(
+               m_text[_pos + _return.length])] == Table::DIGIT) {
+        if (_return.value <= Int16::max)
+            _return.value =
+                _return.value * 10 + (m_text[_pos + _return.length] - '0');
+        if (_return.error < 0 &&
+            (++_digits > Int16::max_digits || _return.value > Int16::max))
+            _return.error = 0;
+        _return.length++;
+    }
+}
+
+// Find the first syntax error
+bool EditableExpression::find_error(Result &_return) const {
+    typedef LexerTable Table;
+    // The first token with an error
+    const TokenNode *_error = nullptr;
+    std::size_t _error_col = 0;
+    unsigned _error_index = 0;
+    if (m_tokens != nullptr && m_tokens->errors > 0) {
+        unsigned _index = 0;
+        std::size_t _chars = 0;
+        for (const TokenNode *_node = m_tokens; _error == nullptr;) {
+            const TokenNode *_left = _node->left;
+            if (_left != nullptr && _left->errors > 0) {
+                _node = _left;
+                continue;
+            }
+            if (_left != nullptr) {
+                _index += _left->count;
+                _chars += _left->chars;
+            }
+            if (_node->token.error >= 0) {
+                _error = _node;
+                _error_index = _index;
+                _error_col = _chars + _node->token.spaces;
+            }
+            _index++;
+            _chars += _node->token.spaces + _node->token.length;
+            _node = _node->right;
+        }
+    }
+
+    // The first closing parenthesis without an opening one (which comes
+    // before the other errors on the same token)
+    if (m_tokens != nullptr && m_tokens->lowest < 0) {
+        unsigned _index = 0;
+        std::size_t _chars = 0;
+        int _depth = 0;
+        for (const TokenNode *_node = m_tokens;;) {
+            const TokenNode *_left = _node->left;
+            if (_left != nullptr && _depth + _left->lowest < 0) {
+                _node = _left;
+                continue;
+            }
+            if (_left != nullptr) {
+                _index += _left->count;
+                _chars += _left->chars;
+                _depth += _left->depth;
+            }
+            _depth += _node->token.depth();
+            if (_depth < 0) {
+                if (_error != nullptr && _error_index < _index)
+                    break;
+                _return.error = 4;
+                _return.col = _chars + _node->token.spaces;
+                return false;
+            }
+            _index++;
+            _chars += _node->token.spaces + _node->token.length;
+            _node = _node->right;
+        }
+    }
+    if (_error != nullptr) {
+        _return.error = _error->token.error;
+        _return.col = _error_col;
+        return false;
+    }
+
+    // The line end, after the last token (and the whitespaces after it)
+    Table::State _state = Table::AFTER_NOTHING;
+    if (m_tokens != nullptr) {
+        const TokenNode *_last = m_tokens;
+        while (_last->right != nullptr)
+            _last = _last->right;
+        _state = _last->token.after.state;
+    }
+    if (m_text.size() > (m_tokens != nullptr ? m_tokens->chars : 0))
+        _state = Table::transitions[_state][Table::SPACE].next;
+    if (Table::transitions[_state][Table::END].error >= 0) {
+        _return.error = Table::transitions[_state][Table::END].error;
+        _return.col = m_text.size();
+        return false;
+    }
+
+    // The last opening parenthesis opened out of all others, if any isn't
+    // closed
+    if (m_tokens != nullptr && m_tokens->depth != 0) {
+        std::size_t _chars = 0;
+        int _depth = 0;
+        for (const TokenNode *_node = m_tokens;;) {
+            const TokenNode *_left = _node->left, *_right = _node->right;
+            int _before = _depth + (_left != nullptr ? _left->depth : 0);
+            std::size_t _after = _chars +
+                                 (_left != nullptr ? _left->chars : 0) +
+                                 _node->token.spaces + _node->token.length;
+            if (_right != nullptr && _right->lowest_opening != INT_MAX &&
+                _before + _node->token.depth() + _right->lowest_opening == 0) {
+                _depth = _before + _node->token.depth();
+                _chars = _after;
+                _node = _right;
+                continue;
+            }
+            if (_node->token.kind == Table::OPENING && _before == 0) {
+                _return.error = 6;
+                _return.col = _after - 1;
+                return false;
+            }
+            _node = _left;
+        }
+    }
+    return true;
+}
+
+// Mark the tokens changed
+void EditableExpression::touch(unsigned _begin, unsigned _end,
+                               unsigned _size) {
+    long _delta = long(_size) - long(_end - _begin);
+    if (!m_dirty) {
+        m_dirty = true;
+        m_dirty_begin = _begin;
+        m_dirty_end = _begin + _size;
+        m_dirty_delta = _delta;
+        return;
+    }
+    // The range marked before, moved by this edit
+    unsigned _old_begin = m_dirty_begin <= _begin ? m_dirty_begin
+                          : m_dirty_begin >= _end ? m_dirty_begin + _delta
+                                                  : _begin;
+    unsigned _old_end = m_dirty_end <= _begin ? m_dirty_end
+                        : m_dirty_end >= _end ? m_dirty_end + _delta
+                                              : _begin + _size;
+    m_dirty_begin = std::min(_old_begin, _begin);
+    m_dirty_end = std::max(_old_end, _begin + _size);
+    m_dirty_delta += _delta;
+}
+
+// Update the groups
+void EditableExpression::update() {
+    if (m_root != nullptr && m_root->terms != nullptr && !m_dirty)
+        return;
+    std::vector<Token> _tokens;
+    std::vector<TermNode *> _terms;
+
+    if (m_root != nullptr && m_root->terms != nullptr) {
+        // The tokens (on the groups) before and after the changed ones
+        unsigned _count = m_root->tokens();
+        unsigned _first = m_dirty_begin > 0 ? m_dirty_begin - 1 : 0;
+        long _after = long(m_dirty_end) - m_dirty_delta;
+        unsigned _last = _after < long(_count) ? _after : _count - 1;
+
+        // The innermost group with both inside its parentheses
+        std::vector<std::pair<Group *, unsigned>> _path;
+        Group *_group = m_root;
+        unsigned _base = 0;
+        while (true) {
+            _path.emplace_back(_group, _base);
+            unsigned _index, _start, _other;
+            TermNode *_term = term_at(_group->terms, _first - _base, _index,
+                                      _start);
+            if (term_at(_group->terms, _last - _base, _other, _start) !=
+                _term)
+                break;
+            // The item with the first one
+            unsigned _pos = _base + tokens_before(_group->terms, _index) +
+                            (_term->term.sign != 0);
+            Group *_child = nullptr;
+            for (const auto &_item : _term->term.items) {
+                unsigned _size =
+                    _item.group != nullptr ? _item.group->tokens() : 1;
+                if (_first < _pos + _size) {
+                    if (_item.group != nullptr && _first > _pos &&
+                        _last < _pos + _size - 1)
+                        _child = _item.group;
+                    break;
+                }
+                _pos += _size;
+            }
+            if (_child == nullptr)
+                break;
+            _group = _child;
+            _base = _pos + 1;
+        }
+
+        // Read again the terms from the one with the first to the one with
+        // the last (as both are the same, these terms begin and end on the
+        // same tokens), on the group around them if they don't fit on the
+        // group anymore
+        while (!_path.empty()) {
+            std::tie(_group, _base) = _path.back();
+            _path.pop_back();
+            unsigned _begin, _end, _start;
+            term_at(_group->terms, _first - _base, _begin, _start);
+            term_at(_group->terms, _last - _base, _end, _start);
+            _end++;
+            unsigned _first_token = _base + tokens_before(_group->terms, _begin);
+            unsigned _last_token = _base + tokens_before(_group->terms, _end);
+
+            _tokens.clear();
+            collect(m_tokens, _first_token, _last_token + m_dirty_delta, 0,
+                    _tokens);
+            if (!parse(_tokens, _begin > 0, _group, _terms))
+                continue;
+            TermNode *_left, *_middle, *_right;
+            split(_group->terms, _end, _middle, _right);
+            split(_middle, _begin, _left, _middle);
+            destroy_terms(_middle);
+            _group->terms = merge(merge(_left, build(_terms)), _right);
+            if (_group->terms != nullptr)
+                _group->terms->parent = nullptr;
+            settle(_group);
+            m_dirty = false;
+            return;
+        }
+    }
+
+    // Read all tokens (the first time, or if the text had no terms)
+    if (m_root != nullptr)
+        destroy_terms(m_root->terms);
+    delete m_root;
+    m_root = new Group;
+    _tokens.clear();
+    collect(m_tokens, 0, count_of(m_tokens), 0, _tokens);
+    if (parse(_tokens, false, m_root, _terms))
+        m_root->terms = build(_terms);
+    if (m_root->terms != nullptr)
+        m_root->terms->parent = nullptr;
+    m_root->evaluate();
+    m_dirty = false;
+}
+
+// Read a sequence of terms
+bool EditableExpression::parse(const std::vector<Token> &_tokens,
+                               bool _signed, Group *_group,
+                               std::vector<TermNode *> &_return) {
+    // A frame by group open (without recursion, as the groups may be deeply
+    // nested): the group, its terms and the term being read
+    struct Frame {
+        Group *group;
+        std::vector<TermNode *> terms;
+        TermNode *term;
+    };
+    std::vector<Frame> _frames;
+    _frames.push_back({_group, {}, nullptr});
+    bool _good = true;
+
+    auto _finish = [](Frame &_frame) {
+        _frame.term->term.evaluate();
+        _frame.terms.push_back(_frame.term);
+        _frame.term = nullptr;
+    };
+    auto _new_term = [this](char _sign) {
+        auto _node = new TermNode;
+        _node->priority = priority();
+        _node->term.sign = _sign;
+        _node->term.tokens = _sign != 0;
+        return _node;
+    };
+
+    for (std::size_t i = 0; _good && i < _tokens.size(); i++) {
+        const Token &t = _tokens[i];
+        Frame *_frame = &_frames.back();
+        // A binary '+' or '-' begins a term
+        if (t.symbol == '+' || (t.symbol == '-' && !t.unary)) {
+            if (_frame->term != nullptr && !_frame->term->term.items.empty())
+                _finish(*_frame);
+            else if (i != 0 || !_signed || _frame->term != nullptr)
+                _good = false;
+            _frame->term = _new_term(t.symbol);
+            continue;
+        }
+        if (_frame->term == nullptr)
+            _frame->term = _new_term(0);
+        Term &_term = _frame->term->term;
+
+        switch (t.kind) {
+            case LexerTable::DIGIT:
+                _term.items.push_back({Item::NUMBER, t.value});
+                _term.tokens++;
+                break;
+            case LexerTable::MINUS:
+                _term.items.push_back({Item::NEGATE, '-'});
+                _term.tokens++;
+                break;
+            case LexerTable::SYMBOL:
+                _term.items.push_back({Item::OPERATOR, t.symbol});
+                _term.tokens++;
+                break;
+            case LexerTable::OPENING: {
+                auto _child = new Group;
+                _child->parent = _frame->group;
+                _frames.push_back({_child, {}, nullptr});
+                break;
+            }
+            case LexerTable::CLOSING: {
+                if (_frames.size() == 1 || _term.items.empty()) {
+                    _good = false;
+                    break;
+                }
+                _finish(*_frame);
+                Group *_child = _frame->group;
+                _child->terms = build(_frame->terms);
+                _child->terms->parent = nullptr;
+                _child->evaluate();
+                _frames.pop_back();
+                _frame = &_frames.back();
+                _child->owner = _frame->term;
+                _frame->term->term.items.push_back({Item::GROUP, 0, _child});
+                _frame->term->term.tokens += _child->tokens();
+                break;
+            }
+            default:
+                _good = false;
+        }
+    }
+    if (_good && (_frames.size() != 1 ||
+                  (_frames[0].term != nullptr &&
+                   _frames[0].term->term.items.empty())))
+        _good = false;
+
+    if (!_good) {
+        // Delete all read, from the innermost group open
+        while (!_frames.empty()) {
+            Frame &_frame = _frames.back();
+            if (_frame.term != nullptr)
+                _frame.terms.push_back(_frame.term);
+            for (TermNode *_node : _frame.terms) {
+                _node->left = _node->right = nullptr;
+                destroy_terms(_node);
+            }
+            if (_frames.size() > 1)
+                delete _frame.group;
+            _frames.pop_back();
+        }
+        return false;
+    }
+    if (_frames[0].term != nullptr)
+        _finish(_frames[0]);
+    _return = std::move(_frames[0].terms);
+    return true;
+}
+
+// Evaluate a group and the groups around it
+void EditableExpression::settle(Group *_group) {
+    _group->evaluate();
+    while (_group->owner != nullptr) {
+        // The term with the group, and its nodes up to the root
+        TermNode *_node = _group->owner;
+        Term &_term = _node->term;
+        _term.tokens = _term.sign != 0;
+        for (const auto &_item : _term.items)
+            _term.tokens += _item.group != nullptr ? _item.group->tokens() : 1;
+        _term.evaluate();
+        for (; _node != nullptr; _node = _node->parent)
+            _node->update();
+        _group = _group->parent;
+        _group->evaluate();
+    }
+}
+
+// Get a priority
+std::uint32_t EditableExpression::priority() {
+    // Xorshift
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+    return m_seed;
+}
+
+// Calculate
+bool EditableExpression::calculate(Result &_return) {
+    _return = Result();
+    if (!find_error(_return))
+        return false;
+    // The juxtapositions are evaluated by an Expression
+    if (m_tokens != nullptr && m_tokens->quirks > 0) {
+        m_expr.reset(m_text);
+        return m_expr.calculate(_return);
+    }
+    update();
+    _return = m_root->result;
+    _return.empty = m_text.empty();
+    if (!_return.is_error())
+        _return.zeros = Expression::leading_zeros(m_text);
+    return !_return.is_error();
+}
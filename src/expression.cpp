@@ -6,15 +6,26 @@
  *  File with Expression Class implementations
  */
 
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <functional>
 #include <iostream>
-#include <cassert>
-#include <cmath>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "stack.hpp"
 #include "queue.hpp"
+#include "arithmetic.hpp"
 #include "errors.hpp"
 #include "expression.hpp"
+#include "kernels.hpp"
+#include "numeric.hpp"
+#include "profiler.hpp"
+#include "program.hpp"
+#include "result.hpp"
 #include "term.hpp"
 
 // Errors Array content initialization
@@ -30,370 +41,525 @@ std::string Errors::m_errors[] = {
     "Numeric overflow error!"
 };
 
+// Errors IDs Array content initialization
+std::string Errors::m_error_ids[] = {
+    "E1 ", "E2 ", "E3 ", "E4 ", "E5 ", "E6 ", "E7 ", "E8", "E9"
+};
+
+// Lines scanned before lexing (the shorter ones are lexed byte by byte)
+static const unsigned SCAN_MIN_SIZE = 256;
+// Characters by term from which the Lexer reads only the terms begin of a
+// scanned line (on denser lines, reading byte by byte is faster)
+static const unsigned SCAN_MIN_SPREAD = 5;
+
 // Constructor
-Expression::Expression(std::string _expr) : m_expr(_expr) {
-    m_terms         = new Queue<Term>;
-    m_terms_postfix = new Queue<Term>;
+template <typename Policy>
+BasicExpression<Policy>::BasicExpression(std::string _expr)
+    : m_text(std::move(_expr)) {
+    m_expr          = m_text;
+    m_error.id      = -1;
+    m_error.col     = -1;
+}
+
+// Constructor (C string)
+template <typename Policy>
+BasicExpression<Policy>::BasicExpression(const char *_expr)
+    : BasicExpression(std::string(_expr)) {}
+
+// Constructor (without copy)
+template <typename Policy>
+BasicExpression<Policy>::BasicExpression(std::string_view _expr,
+                                         std::pmr::memory_resource *_resource)
+    : m_expr(_expr), m_allocator(_resource) {
     m_error.id      = -1;
     m_error.col     = -1;
 }
 
 // Destructor
-Expression::~Expression() {
-    delete m_terms;
-    delete m_terms_postfix;
+template <typename Policy>
+BasicExpression<Policy>::~BasicExpression() {}
+
+// Reset
+template <typename Policy>
+void BasicExpression<Policy>::reset(std::string_view _expr) {
+    m_expr      = _expr;
+    m_error.id  = -1;
+    m_error.col = -1;
+    m_variables = nullptr;
+    m_terms.makeEmpty();
+    m_terms_postfix.makeEmpty();
+    reset_stacks();
 }
 
-// Tokenize
-bool Expression::tokenize() {
-    bool _was_number = false;
-    bool _was_whitespace = false;
-    bool _was_opening_parenthesis = false;
-    bool _was_closing_parenthesis = false;
-    bool _was_operator = false;
-    int _parenthesis_diff = 0;
-    int _fst_parenthesis = -1;
-
-    Term t1, t2;
-    for (auto i(0u); i < m_expr.size(); i++) {
-        t2.set(m_expr[i], i);
-        bool _is_number = is_number(t2);
-        bool _is_operator = is_operator(t2);
-        bool _is_opening_parenthesis = is_opening_parenthesis(t2);
-        bool _is_closing_parenthesis = is_closing_parenthesis(t2);
-        bool _is_parenthesis = (_is_opening_parenthesis || _is_closing_parenthesis);
-        bool _is_last_operand = (i == m_expr.size() - 1);
-        bool _is_whitespace = (t2.value == " ");
-        bool _was_parenthesis = (_was_opening_parenthesis || _was_closing_parenthesis);
-
-        // Verify if the current term is a whitespace
-        if (_is_whitespace) {
-            _was_whitespace = true;
-            if (_is_last_operand) {
-                if (_was_number) {
-                    m_terms->enqueue(t1);
-                    t1.value = "";
-                } else if (!_was_closing_parenthesis) {
-                    set_error(1, t2.col + 1);
-                    return false;
-                }
-            }
-            continue;
-        // Verify if the current term is a number
-        } else if (_is_number) {
-            if ((_was_number && _was_whitespace) || _was_closing_parenthesis) {
-                set_error(3, t2.col);
-                return false;
-            }
-            if (_was_number) {
-                t1.value += t2.value;
-            } else {
-                t1.set(t2.value, i);
-            }
-            if (!is_valid_number(t1)) {
-                set_error(0, t1.col);
-                return false;
-            }
-            if (_is_last_operand)
-                m_terms->enqueue(t1);
-            _was_number = true;
-            _was_opening_parenthesis = false;
-            _was_closing_parenthesis = false;
-            _was_operator = false;
-        // Verify if the current term is a operator or parenthesis
-        } else if (_is_operator || _is_parenthesis) {
-            if (_was_number) {
-                m_terms->enqueue(t1);
-                t1.value = "";
-            }
-            _fst_parenthesis = (_parenthesis_diff == 0) ? -1 : _fst_parenthesis;
-            if (_is_parenthesis) {
-                if (_parenthesis_diff == 0)
-                    _fst_parenthesis = t2.col;
-                _parenthesis_diff += _is_opening_parenthesis ? 1 : -1;
-            }
-            if (_parenthesis_diff < 0) {
-                set_error(4, t2.col);
-                return false;
-            }
-            if (!_was_number) {
-                if (t2.value == "-" && !_was_closing_parenthesis) {
-                    t2.is_unary = true;
-                } else if (!_is_parenthesis && !_was_parenthesis) {
-                    set_error(5, t2.col);
-                    return false;
-                } else if (_was_operator && _is_closing_parenthesis) {
-                    set_error(1, t2.col);
-                    return false;
-                }
-            }
-            if (_is_last_operand && !_is_parenthesis) {
-                set_error(1, t2.col + 1);
-                return false;
-            }
-            if (_is_opening_parenthesis && _was_closing_parenthesis) {
-                set_error(3, t2.col);
-                return false;
-            }
-            if (_is_closing_parenthesis && _was_opening_parenthesis) {
-                set_error(1, t2.col);
-                return false;
-            }
-            m_terms->enqueue(t2);
-            _was_number = false;
-            if (_is_operator) {
-                _was_operator = true;
-                _was_opening_parenthesis = false;
-                _was_closing_parenthesis = false;
-            } else {
-                _was_operator = false;
-                if (_is_opening_parenthesis) {
-                    _was_opening_parenthesis = true;
-                    _was_closing_parenthesis = false;
-                } else {
-                    _was_opening_parenthesis = false;
-                    _was_closing_parenthesis = true;
-                }
-            }
-        // Invalid Operand
-        } else {
-            set_error(_was_operator ? 1 : 2, t2.col);
-            return false;
-        }
-        _was_whitespace = false;
+// Lexer
+template <typename Policy>
+template <typename Sink>
+bool BasicExpression<Policy>::lex(Sink &&_sink) {
+    Lexer lexer(m_expr);
+    auto _find_variable = [this](unsigned _begin, unsigned &_end,
+                                 int &_index) {
+        return find_variable(_begin, _end, _index);
+    };
+    auto _skip = [](const Term &) { return true; };
+    bool _lexed;
+    if (m_expr.size() < SCAN_MIN_SIZE) {
+        _lexed = lexer.lex(_sink, _find_variable);
+    } else {
+        // A long line is scanned first, finding where its terms begin
+        m_starts.resize((m_expr.size() + 63) / 64);
+        bool _invalid = Kernels::scan(m_expr.data(), m_expr.size(),
+                                      m_starts.data()) < m_expr.size();
+        std::size_t _terms = 0;
+        for (auto _word : m_starts)
+            _terms += __builtin_popcountll(_word);
+        // Reading only the terms begin pays if they're sparse (e.g. there
+        // are runs of whitespaces), and a line with an invalid character
+        // has a syntax error, so its terms don't need to be evaluated
+        if (_terms * SCAN_MIN_SPREAD <= m_expr.size())
+            _lexed = _invalid
+                ? lexer.lex(m_starts.data(), _skip, _find_variable)
+                : lexer.lex(m_starts.data(), _sink, _find_variable);
+        else
+            _lexed = _invalid ? lexer.lex(_skip, _find_variable)
+                              : lexer.lex(_sink, _find_variable);
     }
+    if (_lexed)
+        return true;
+    // A failed sink has already set its own error
+    if (lexer.error_id() >= 0)
+        set_error(lexer.error_id(), lexer.error_col());
+    return false;
+}
 
-    if (_parenthesis_diff != 0) {
-        set_error(6, _fst_parenthesis);
+// Find a declared variable
+template <typename Policy>
+bool BasicExpression<Policy>::find_variable(unsigned _begin, unsigned &_end,
+                                            int &_index) const {
+    // As unsigned char, as the Lexer table (any byte may be on the line)
+    auto _char = [this](unsigned _pos) {
+        return static_cast<unsigned char>(m_expr[_pos]);
+    };
+    if (m_variables == nullptr || !(isalpha(_char(_begin)) || _char(_begin) == '_'))
         return false;
+
+    _end = _begin + 1;
+    while (_end < m_expr.size() && (isalnum(_char(_end)) || _char(_end) == '_'))
+        _end++;
+
+    for (auto k(0u); k < m_variables->size(); k++) {
+        if ((*m_variables)[k] == m_expr.substr(_begin, _end - _begin)) {
+            _index = k;
+            return true;
+        }
     }
+    return false;
+}
 
-    return true;
+// Tokenize
+template <typename Policy>
+bool BasicExpression<Policy>::tokenize() {
+    return lex([this](const Term &_t) { return m_terms.enqueue(_t); });
+}
+
+// Shunting-yard step
+template <typename Policy>
+template <typename Sink>
+bool BasicExpression<Policy>::shunt(const Term &_t, TermStack &_operators,
+                                    Sink &&_sink) {
+    return ShuntingYard::shunt(_t, _operators, _sink, m_error.id,
+                               m_error.col);
 }
 
-bool Expression::infix2postfix() {
-    Stack<Term> *operators = new Stack<Term>;
-    Term t1, t2;
+// Shunting-yard ending
+template <typename Policy>
+template <typename Sink>
+bool BasicExpression<Policy>::shunt_end(TermStack &_operators, Sink &&_sink) {
+    return ShuntingYard::shunt_end(_operators, _sink, m_error.id,
+                                   m_error.col);
+}
+
+// Infix to Postfix
+template <typename Policy>
+bool BasicExpression<Policy>::infix2postfix() {
+    reset_stacks();
+    auto _enqueue = [this](const Term &_t) {
+        return m_terms_postfix.enqueue(_t);
+    };
+    Term t1;
     // Verify all terms on queue
-    while (!m_terms->isEmpty()) {
-        m_terms->dequeue(t1);
-        operators->top(t2);
-        // If is a number, send to postfix queue
-        if (is_number(t1)) {
-            m_terms_postfix->enqueue(t1);
-        // If isn't a number and the queue is empty or is
-        // an opening parenthesis, send to operators stack
-        } else if (operators->isEmpty() || is_opening_parenthesis(t1)) {
-            // If the tokenize is right, this never should happen
-            if (is_closing_parenthesis(t1)) {
-                set_error(4, t1.col);
-                delete operators;
-                return false;
-            }
-            operators->push(t1);
-        // If is a closing parenthesis, send all the operators
-        // until the opening parenthesis to postfix queue
-        } else if (is_closing_parenthesis(t1)) {
-            while (!is_opening_parenthesis(t2)) {
-                operators->pop(t2);
-                m_terms_postfix->enqueue(t2);
-                operators->top(t2);
-            }
-            assert(is_opening_parenthesis(t2));
-            operators->pop(t2);
-        // Else, remove all operators who have a minor
-        // precedence and push him to operators stack
-        } else {
-            while (get_precedence(t1) >= get_precedence(t2) &&
-                   !operators->isEmpty() && !is_opening_parenthesis(t2)) {
-                operators->pop(t2);
-                m_terms_postfix->enqueue(t2);
-                operators->top(t2);
-            }
-            operators->push(t1);
-        }
-    }
-    // Remove remaining terms on Stack
-    while (!operators->isEmpty()) {
-        operators->pop(t2);
-        // If the tokenize is right, this never should happen
-        if (is_opening_parenthesis(t2)) {
-            set_error(6, t2.col);
-            delete operators;
+    while (m_terms.dequeue(t1))
+        if (!shunt(t1, m_operators, _enqueue))
             return false;
-        }
-        m_terms_postfix->enqueue(t2);
-    }
 
-    // Delete operators Stack to avoid memory leak
-    delete operators;
+    return shunt_end(m_operators, _enqueue);
+}
 
-    return true;
+// Reset the Stacks
+template <typename Policy>
+void BasicExpression<Policy>::reset_stacks() {
+    m_operators.makeEmpty();
+    m_operands.stack.makeEmpty();
+    m_operands.lhs = Term();
+    m_operands.rhs = Term();
+}
+
+// Reduce
+template <typename Policy>
+bool BasicExpression<Policy>::reduce(const Term &_t, Operands &_operands) {
+    return ShuntingYard::reduce(_t, _operands.stack, _operands.lhs,
+                                _operands.rhs, m_error.id, m_error.col);
 }
 
 // Calculate
-bool Expression::calculate(std::string &_return) {
+template <typename Policy>
+bool BasicExpression<Policy>::calculate(Result &_return, Mode _mode) {
     Term result;
+    bool _succeed = _mode == FUSED
+        ? evaluate(result)
+        : tokenize() && infix2postfix() && get_result(result);
 
+    _return = Result();
     // Try to do all operations
-    if (!tokenize() || !infix2postfix() || !get_result(result)) {
-        _return = Errors::get_error_message(m_error.id, m_error.col);
+    if (!_succeed) {
+        _return.error = m_error.id;
+        _return.col   = m_error.col;
         return false;
     }
 
-    _return = result.value;
+    // An empty expression has no terms, so it has an empty result
+    _return.value = result.value;
+    _return.empty = m_expr.empty();
+    _return.zeros = leading_zeros(m_expr);
     return true;
 }
 
-bool Expression::get_result(Term &_return) {
-    Stack<Term> *operands = new Stack<Term>;
-    Term t1, t2, t3;
+// Calculate (measuring each phase)
+template <typename Policy>
+bool BasicExpression<Policy>::calculate(Result &_return,
+                                        Profiler &_profiler) {
+    Term result;
+    _profiler.start(Profiler::TOKENIZE);
+    bool _succeed = tokenize();
+    _profiler.stop(Profiler::TOKENIZE);
+    if (_succeed) {
+        _profiler.start(Profiler::INFIX2POSTFIX);
+        _succeed = infix2postfix();
+        _profiler.stop(Profiler::INFIX2POSTFIX);
+    }
+    if (_succeed) {
+        _profiler.start(Profiler::GET_RESULT);
+        _succeed = get_result(result);
+        _profiler.stop(Profiler::GET_RESULT);
+    }
 
-    while (!m_terms_postfix->isEmpty()) {
-        m_terms_postfix->dequeue(t1);
-        // If is a number, push him to the operands Stack
-        if (is_number(t1)) {
-            operands->push(t1);
-        } else {
-            operands->pop(t2);
-            // If is unary, set the first term as 0
-            if (t1.is_unary) {
-                t3.value = "0";
-            } else {
-                operands->pop(t3);
-            }
-            // Try to apply operation
-            if (apply_operation(t3, t2, t1, t2)) {
-                operands->push(t2);
-            } else {
-                delete operands;
-                return false;
-            }
-        }
+    _return = Result();
+    if (!_succeed) {
+        _return.error = m_error.id;
+        _return.col   = m_error.col;
+        return false;
+    }
+
+    _return.value = result.value;
+    _return.empty = m_expr.empty();
+    _return.zeros = leading_zeros(m_expr);
+    return true;
+}
+
+// Calculate to string
+template <typename Policy>
+bool BasicExpression<Policy>::calculate(std::string &_return, Mode _mode) {
+    Result result;
+    if (!calculate(result, _mode)) {
+        _return = Errors::get_error_message(result.error, result.col);
+        return false;
     }
 
-    operands->pop(_return);
+    _return = result.empty ? ""
+                           : std::string(result.zeros, '0') +
+                                 std::to_string(result.value);
+    return true;
+}
 
-    // Delete operands Stack to avoid memory leak
-    delete operands;
+// Compile with variables
+template <>
+bool BasicExpression<Int16>::compile_program(
+    Program &_return, const std::vector<std::string> &_variables) {
+    reset_stacks();
+    unsigned _size = 0;
+
+    _return = Program();
+    _return.m_variables = _variables.size();
+    // Emit the postfix terms as instructions, tracking the operands Stack size
+    auto _emit = [&](const Term &_t) {
+        Program::Instruction _i;
+        if (is_number(_t)) {
+            _i = {Program::PUSH, _t.value};
+            _size++;
+        } else if (is_variable(_t)) {
+            _i = {Program::LOAD, _t.value};
+            _size++;
+        } else if (_t.is_unary) {
+            _i = {Program::NEG, 0};
+            _return.m_balanced = _return.m_balanced && _size >= 1;
+            _size = _size ? _size : 1;
+        } else {
+            _i = {static_cast<Program::Opcode>(_t.value), 0};
+            _return.m_balanced = _return.m_balanced && _size >= 2;
+            _size = _size > 2 ? _size - 1 : 1;
+        }
+        _return.m_depth = std::max(_return.m_depth, _size);
+        _return.m_program.push_back(_i);
+        _return.m_columns.push_back(_t.col);
+        return true;
+    };
+    auto _shunt = [&](const Term &_t) {
+        return shunt(_t, m_operators, _emit);
+    };
+
+    m_variables = &_variables;
+    bool _succeed = lex(_shunt) && shunt_end(m_operators, _emit);
+    m_variables = nullptr;
+
+    if (!_succeed) {
+        _return = Program();
+        _return.m_error.id  = m_error.id;
+        _return.m_error.col = m_error.col;
+        return false;
+    }
 
+    _return.m_zeros = leading_zeros(m_expr);
     return true;
 }
 
-// Aplly Operation
-bool Expression::apply_operation(Term _t1, Term _t2, Term _op, Term &_rst) {
-    if (is_operator(_op)) {
-        int result, v1, v2;
-        if (!is_valid_number(_t1) || !is_valid_number(_t2)) {
-            set_error(8);
-            return false;
+// Subexpressions shared by a batch (hash-consed postfix terms)
+template <typename Policy>
+struct BasicExpression<Policy>::Subexpressions {
+    //! A subexpression, evaluated when it's added
+    struct Node {
+        value_type value;  //!< The value
+        int error;         //!< The evaluation error (or -1)
+    };
+    //! The subexpression key (the operator and its operands nodes)
+    struct Key {
+        int op;            //!< The Program::Opcode
+        unsigned lhs;      //!< The left operand node
+        unsigned rhs;      //!< The right operand node
+        value_type value;  //!< The PUSH value
+        bool operator==(const Key &_k) const {
+            return op == _k.op && lhs == _k.lhs && rhs == _k.rhs &&
+                   value == _k.value;
         }
-        get_int_number(_t1, v1);
-        get_int_number(_t2, v2);
-        switch (_op.value[0]) {
-            case '^':
-                result = std::pow(v1, v2);
-                break;
-            case '*':
-                result = v1 * v2;
-                break;
-            case '/':
-                if (v2 == 0) {
-                    set_error(7);
-                    return false;
-                }
-                result = v1 / v2;
-                break;
-            case '%':
-                if (v2 == 0) {
-                    set_error(7);
-                    return false;
-                }
-                result = v1 % v2;
-                break;
-            case '+':
-                result = v1 + v2;
-                break;
-            case '-':
-                result = v1 - v2;
-                break;
+    };
+    //! The subexpression key hash
+    struct Hash {
+        std::size_t operator()(const Key &_k) const {
+            std::uint64_t _h = (std::uint64_t(_k.lhs) << 32 | _k.rhs) ^
+                               (std::uint64_t(_k.op) << 56) ^
+                               std::uint64_t(_k.value) * 0xff51afd7ed558ccdULL;
+            _h *= 0x9e3779b97f4a7c15ULL;
+            return _h ^ (_h >> 32);
         }
-        _rst.value = std::to_string(result);
-        if (!is_valid_number(_rst)) {
-            set_error(8);
-            return false;
+    };
+
+    std::pmr::vector<Node> nodes;                   //!< The subexpressions
+    std::pmr::unordered_map<Key, unsigned, Hash> index;  //!< Key to node
+
+    // Constructor (on the batch memory)
+    explicit Subexpressions(std::pmr::memory_resource *_resource)
+        : nodes(_resource), index(0, Hash(), std::equal_to<Key>(), _resource) {}
+
+    // Add a subexpression, evaluating it only if it's new
+    unsigned add(int _op, unsigned _lhs, unsigned _rhs, value_type _value = 0) {
+        auto _it = index.emplace(Key{_op, _lhs, _rhs, _value}, nodes.size());
+        if (!_it.second)
+            return _it.first->second;
+
+        Node _node{_value, -1};
+        if (_op != Program::PUSH) {
+            // The first error on postfix order comes from the left operand
+            value_type _v1 = 0;
+            const Node &_r = nodes[_rhs];
+            if (_op != Program::NEG) {
+                const Node &_l = nodes[_lhs];
+                _node.error = _l.error;
+                _v1 = _l.value;
+            }
+            if (_node.error < 0)
+                _node.error = _r.error;
+            if (_node.error < 0 &&
+                !Arithmetic::apply(_op == Program::NEG ? '-' : _op, _v1,
+                                   _r.value, _node.value, _node.error))
+                _node.value = 0;
         }
-        return true;
+        nodes.push_back(_node);
+        return _it.first->second;
     }
+};
 
-    return false;
-}
+// Share the subexpressions
+template <typename Policy>
+bool BasicExpression<Policy>::share(Subexpressions &_shared,
+                                    std::pmr::vector<unsigned> &_roots,
+                                    bool &_balanced) {
+    reset_stacks();
+    _roots.clear();
+    _balanced = true;
+
+    // The operands Stack keeps nodes, instead of values
+    auto _add = [&](const Term &_t) {
+        if (is_number(_t)) {
+            _roots.push_back(_shared.add(Program::PUSH, 0, 0, _t.value));
+            return true;
+        }
+        if (_roots.size() < (_t.is_unary ? 1u : 2u)) {
+            _balanced = false;
+            return false;
+        }
+        unsigned _rhs = _roots.back();
+        _roots.pop_back();
+        if (_t.is_unary) {
+            _roots.push_back(_shared.add(Program::NEG, _rhs, _rhs));
+        } else {
+            unsigned _lhs = _roots.back();
+            _roots.back() = _shared.add(_t.value, _lhs, _rhs);
+        }
+        return true;
+    };
+    auto _shunt = [&](const Term &_t) {
+        return shunt(_t, m_operators, _add);
+    };
 
-// Sets the Error
-void Expression::set_error(const int _id, const int _col) {
-    m_error.id  = _id;
-    m_error.col = _col;
+    return lex(_shunt) && shunt_end(m_operators, _add);
 }
 
+// Calculate a batch
+template <typename Policy>
+void BasicExpression<Policy>::calculate_batch(
+    const std::vector<std::string_view> &_exprs, std::vector<Result> &_return,
+    std::pmr::memory_resource *_resource) {
+    Subexpressions shared(_resource);
+    std::pmr::vector<unsigned> roots(_resource);
+    bool balanced;
+
+    BasicExpression expr(std::string_view(), _resource);
+    _return.assign(_exprs.size(), Result());
+    for (auto i(0u); i < _exprs.size(); i++) {
+        expr.reset(_exprs[i]);
+        Result &_result = _return[i];
+
+        if (!expr.share(shared, roots, balanced)) {
+            // Stale operands can't be shared, so evaluate it alone
+            if (!balanced) {
+                expr.reset(_exprs[i]);
+                expr.calculate(_result);
+                continue;
+            }
+            _result.error = expr.m_error.id;
+            _result.col   = expr.m_error.col;
+            continue;
+        }
 
-// Gets Term precedence
-int Expression::get_precedence(Term _t) const {
-    if (is_opening_parenthesis(_t) || is_closing_parenthesis(_t))
-        return 1;
-    if (is_operator(_t)) {
-        if (_t.value == "-" && _t.is_unary)
-            return 2;
-        switch (_t.value[0]) {
-            case '^':
-                return 3;
-            case '*':
-            case '/':
-            case '%':
-                return 4;
-            case '+':
-            case '-':
-                return 5;
+        // Any operand left on the Stack was evaluated, so its error counts
+        for (auto _root : roots) {
+            if (shared.nodes[_root].error >= 0) {
+                _result.error = shared.nodes[_root].error;
+                break;
+            }
         }
+        if (!_result.is_error() && !roots.empty())
+            _result.value = shared.nodes[roots.back()].value;
+        _result.empty = !_result.is_error() && _exprs[i].empty();
+        if (!_result.is_error())
+            _result.zeros = leading_zeros(_exprs[i]);
     }
-    return -1;
 }
 
-// Gets Term integer value
-bool Expression::get_int_number(Term _t, int &_return) const {
-    _return = atoi(_t.value.c_str());
-    return is_number(_t);
+// Leading zeros of the value
+template <typename Policy>
+int BasicExpression<Policy>::leading_zeros(std::string_view _expr) {
+    std::size_t _begin = 0, _end = 0;
+    for (std::size_t i = 0; i < _expr.size(); i++) {
+        switch (LexerTable::classes[static_cast<unsigned char>(_expr[i])]) {
+            case LexerTable::DIGIT:
+                if (i == 0 || _expr[i - 1] < '0' || _expr[i - 1] > '9')
+                    _begin = i;
+                _end = i + 1;
+                break;
+            case LexerTable::SPACE:
+            case LexerTable::OPENING:
+            case LexerTable::CLOSING:
+                break;
+            default:
+                return 0;
+        }
+    }
+    // A zero keeps its last digit
+    int _zeros = 0;
+    while (_begin + 1 < _end && _expr[_begin] == '0') {
+        _begin++;
+        _zeros++;
+    }
+    return _zeros;
 }
 
-// Verify if the Term is a number
-bool Expression::is_number(Term _t) const {
-    for (auto i = _t.value[0] == '-' ? 1u : 0u; i < _t.value.size(); i++)
-        if (_t.value[i] < 48 or _t.value[i] > 57)
+template <typename Policy>
+bool BasicExpression<Policy>::get_result(Term &_return) {
+    reset_stacks();
+    Term t1;
+
+    while (m_terms_postfix.dequeue(t1))
+        if (!reduce(t1, m_operands))
             return false;
-    return !is_operator(_t);
+
+    m_operands.stack.pop(_return);
+    return true;
 }
 
-// Verify if the Term is a valid number
-bool Expression::is_valid_number(Term _t) const {
-    if (_t.value.size() > 6)  // Verify if is a too big number
+// Single pass evaluation
+template <typename Policy>
+bool BasicExpression<Policy>::evaluate(Term &_return) {
+    reset_stacks();
+    bool _reduce_failed = false;
+
+    // An evaluation error doesn't stop the lexer, because a syntax error
+    // found later on the line takes precedence (as in the phased mode)
+    auto _reduce = [&](const Term &_t) {
+        if (!_reduce_failed && !reduce(_t, m_operands))
+            _reduce_failed = true;
+        return true;
+    };
+    auto _shunt = [&](const Term &_t) {
+        return shunt(_t, m_operators, _reduce);
+    };
+
+    if (!lex(_shunt) || !shunt_end(m_operators, _reduce) || _reduce_failed)
         return false;
-    int val;
-    return get_int_number(_t, val) and val >= -32768 and val <= 32767;
+
+    m_operands.stack.pop(_return);
+    return true;
 }
 
-// Verify if the Term is a operator
-bool Expression::is_operator(Term _t) const {
-    if (_t.value == "%" or _t.value == "*" or _t.value == "+" or
-        _t.value == "-" or _t.value == "/" or _t.value == "^")
-        return true;
-    return false;
+// Sets the Error
+template <typename Policy>
+void BasicExpression<Policy>::set_error(const int _id, const int _col) {
+    m_error.id  = _id;
+    m_error.col = _col;
 }
 
-// Verify if the Term is a opening parenthesis
-bool Expression::is_opening_parenthesis(Term _t) const {
-    return _t.value == "(";
+
+// Verify if the Term is a number
+template <typename Policy>
+bool BasicExpression<Policy>::is_number(const Term &_t) const {
+    return _t.kind == Term::NUMBER;
 }
 
-// Verify if the Term is a closing parenthesis
-bool Expression::is_closing_parenthesis(Term _t) const {
-    return _t.value == ")";
+// Verify if the Term is a variable
+template <typename Policy>
+bool BasicExpression<Policy>::is_variable(const Term &_t) const {
+    return _t.kind == Term::VARIABLE;
 }
+
+// The instantiated numeric policies
+template class BasicExpression<Int16>;
+template class BasicExpression<Int32>;
+template class BasicExpression<Int64>;
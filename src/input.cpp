@@ -0,0 +1,142 @@
+/*!
+ *  @file input.cpp
+ *  @brief Input Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with Input Class implementations
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "input.hpp"
+
+// Streaming buffer initial size
+static const std::size_t BLOCK_SIZE = 1 << 16;
+
+// Constructor (file path)
+Input::Input(const std::string &_path) {
+    m_fd = open(_path.c_str(), O_RDONLY);
+    if (m_fd < 0)
+        return;
+    m_owns_fd = true;
+    m_open = true;
+
+    // Map regular files, and read anything else in blocks
+    struct stat _stat;
+    if (fstat(m_fd, &_stat) == 0 && S_ISREG(_stat.st_mode)) {
+        m_size = _stat.st_size;
+        if (m_size == 0)
+            return;
+        void *_map = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (_map != MAP_FAILED) {
+            madvise(_map, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char *>(_map);
+            m_mapped = true;
+            return;
+        }
+        m_size = 0;
+    }
+    m_stream = true;
+    m_buffer.resize(BLOCK_SIZE);
+    m_data = m_buffer.data();
+}
+
+// Constructor (file descriptor)
+Input::Input(int _fd) : m_fd(_fd), m_open(_fd >= 0), m_stream(true) {
+    m_buffer.resize(BLOCK_SIZE);
+    m_data = m_buffer.data();
+}
+
+// Constructor (memory)
+Input::Input(const char *_data, std::size_t _size)
+    : m_open(true), m_data(_data), m_size(_size) {}
+
+// Destructor
+Input::~Input() {
+    if (m_mapped)
+        munmap(const_cast<char *>(m_data), m_size);
+    if (m_owns_fd)
+        close(m_fd);
+}
+
+// Verify if is open
+bool Input::is_open() const {
+    return m_open;
+}
+
+// Verify if all reads succeeded
+bool Input::good() const {
+    return m_open && !m_failed;
+}
+
+// Verify if the lines are stable
+bool Input::is_stable() const {
+    return !m_stream;
+}
+
+// Next line
+bool Input::next(std::string_view &_return) {
+    while (true) {
+        const char *_begin = m_data + m_pos;
+        // The characters already searched aren't searched again, so a long
+        // line read in many blocks is searched only once
+        std::size_t _from = std::max(m_pos, m_scan);
+        auto _nl = _from < m_size ? static_cast<const char *>(
+            std::memchr(m_data + _from, '\n', m_size - _from)) : nullptr;
+        if (_nl != nullptr) {
+            _return = std::string_view(_begin, _nl - _begin);
+            m_pos = m_scan = _nl - m_data + 1;
+            return true;
+        }
+        m_scan = m_size;
+        // Read more (the line may continue on the next block)
+        if (m_stream && fill())
+            continue;
+        // A failed read leaves the line incomplete
+        if (m_failed)
+            return false;
+        // The last line may have no line break
+        if (m_pos < m_size) {
+            _return = std::string_view(_begin, m_size - m_pos);
+            m_pos = m_size;
+            return true;
+        }
+        return false;
+    }
+}
+
+// Fill the buffer
+bool Input::fill() {
+    // Move the incomplete line to the buffer start
+    if (m_pos > 0) {
+        std::memmove(m_buffer.data(), m_buffer.data() + m_pos, m_size - m_pos);
+        m_size -= m_pos;
+        m_scan -= m_pos;
+        m_pos = 0;
+    }
+    // Grow if the line doesn't fit
+    if (m_size == m_buffer.size())
+        m_buffer.resize(m_buffer.size() * 2);
+    m_data = m_buffer.data();
+
+    ssize_t _read;
+    do {
+        _read = read(m_fd, m_buffer.data() + m_size, m_buffer.size() - m_size);
+    } while (_read < 0 && errno == EINTR);
+
+    if (_read < 0)
+        m_failed = true;
+    if (_read <= 0)
+        return false;
+    m_size += _read;
+    return true;
+}
@@ -0,0 +1,358 @@
+/*!
+ *  @file kernels.cpp
+ *  @brief Kernels Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with Kernels Class implementations
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "arithmetic.hpp"
+#include "kernels.hpp"
+#include "lexer.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define _KERNELS_X86_ 1
+#include <immintrin.h>
+#else
+#define _KERNELS_X86_ 0
+#endif
+
+// Scalar version
+static void apply_scalar(int _op, const int *_v1, const int *_v2, int *_rst,
+                         int *_errors, unsigned _size) {
+    for (auto i(0u); i < _size; i++) {
+        if (_errors[i] != -1) {
+            _rst[i] = 0;
+            continue;
+        }
+        int result;
+        if (!Arithmetic::apply(_op, _v1[i], _v2[i], result, _errors[i]))
+            result = 0;
+        _rst[i] = result;
+    }
+}
+
+// Verify if a character can be on an expression (as a variable name letter,
+// if isn't a whitespace, a digit, an operator or a parenthesis)
+static inline bool is_valid_char(unsigned char _c) {
+    return LexerTable::classes[_c] != LexerTable::VARIABLE ||
+           unsigned((_c | 0x20) - 'a') < 26u || _c == '_';
+}
+
+// Scalar version (from the word _word, after a digit if _digit)
+static std::size_t scan_scalar(const char *_text, std::size_t _size,
+                               std::uint64_t *_starts, std::size_t _word = 0,
+                               bool _digit = false) {
+    std::size_t _invalid = _size;
+    for (auto i(_word * 64); i < _size; i++) {
+        unsigned char c = _text[i];
+        bool _is_digit = unsigned(c - '0') < 10u;
+        if (i % 64 == 0)
+            _starts[i / 64] = 0;
+        if (c != ' ' && !(_is_digit && _digit))
+            _starts[i / 64] |= std::uint64_t(1) << (i % 64);
+        if (_invalid == _size && !is_valid_char(c))
+            _invalid = i;
+        _digit = _is_digit;
+    }
+    return _invalid;
+}
+
+#if _KERNELS_X86_
+
+#define _SSE_  __attribute__((target("sse4.1")))
+#define _AVX2_ __attribute__((target("avx2")))
+
+// Sets the error code on the bad rows which don't have an error yet
+_SSE_ static inline __m128i sse_set_error(__m128i _e, __m128i _bad, int _id) {
+    __m128i _free = _mm_cmpeq_epi32(_e, _mm_set1_epi32(-1));
+    return _mm_blendv_epi8(_e, _mm_set1_epi32(_id), _mm_and_si128(_bad, _free));
+}
+
+// Verify which values are out of range
+_SSE_ static inline __m128i sse_out_of_range(__m128i _v) {
+    return _mm_or_si128(_mm_cmpgt_epi32(_v, _mm_set1_epi32(32767)),
+                        _mm_cmplt_epi32(_v, _mm_set1_epi32(-32768)));
+}
+
+// SSE4.1 version
+_SSE_ static void apply_sse(int _op, const int *_v1, const int *_v2,
+                            int *_rst, int *_errors, unsigned _size) {
+    auto i(0u);
+    for (; _op != '^' && i + 4 <= _size; i += 4) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_v1 + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_v2 + i));
+        __m128i e = _mm_loadu_si128(reinterpret_cast<__m128i *>(_errors + i));
+        __m128i r;
+        switch (_op) {
+            case '*':
+                r = _mm_mullo_epi32(a, b);
+                break;
+            case '+':
+                r = _mm_add_epi32(a, b);
+                break;
+            case '-':
+                r = _mm_sub_epi32(a, b);
+                break;
+            default: {
+                // The 16-bit values are exact on doubles, and so is the
+                // truncated quotient
+                __m128i zero = _mm_cmpeq_epi32(b, _mm_setzero_si128());
+                e = sse_set_error(e, zero, 7);
+                b = _mm_blendv_epi8(b, _mm_set1_epi32(1), zero);
+                __m128i q_lo = _mm_cvttpd_epi32(_mm_div_pd(
+                    _mm_cvtepi32_pd(a), _mm_cvtepi32_pd(b)));
+                __m128i q_hi = _mm_cvttpd_epi32(_mm_div_pd(
+                    _mm_cvtepi32_pd(_mm_unpackhi_epi64(a, a)),
+                    _mm_cvtepi32_pd(_mm_unpackhi_epi64(b, b))));
+                r = _mm_unpacklo_epi64(q_lo, q_hi);
+                if (_op == '%')
+                    r = _mm_sub_epi32(a, _mm_mullo_epi32(r, b));
+                break;
+            }
+        }
+        e = sse_set_error(e, sse_out_of_range(r), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(_rst + i), r);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(_errors + i), e);
+    }
+    apply_scalar(_op, _v1 + i, _v2 + i, _rst + i, _errors + i, _size - i);
+}
+
+// Sets the error code on the bad rows which don't have an error yet
+_AVX2_ static inline __m256i avx2_set_error(__m256i _e, __m256i _bad, int _id) {
+    __m256i _free = _mm256_cmpeq_epi32(_e, _mm256_set1_epi32(-1));
+    return _mm256_blendv_epi8(_e, _mm256_set1_epi32(_id),
+                              _mm256_and_si256(_bad, _free));
+}
+
+// Verify which values are out of range
+_AVX2_ static inline __m256i avx2_out_of_range(__m256i _v) {
+    return _mm256_or_si256(_mm256_cmpgt_epi32(_v, _mm256_set1_epi32(32767)),
+                           _mm256_cmpgt_epi32(_mm256_set1_epi32(-32768), _v));
+}
+
+// AVX2 version
+_AVX2_ static void apply_avx2(int _op, const int *_v1, const int *_v2,
+                              int *_rst, int *_errors, unsigned _size) {
+    auto i(0u);
+    for (; _op != '^' && i + 8 <= _size; i += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(_v1 + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(_v2 + i));
+        __m256i e = _mm256_loadu_si256(reinterpret_cast<__m256i *>(_errors + i));
+        __m256i r;
+        switch (_op) {
+            case '*':
+                r = _mm256_mullo_epi32(a, b);
+                break;
+            case '+':
+                r = _mm256_add_epi32(a, b);
+                break;
+            case '-':
+                r = _mm256_sub_epi32(a, b);
+                break;
+            default: {
+                // The 16-bit values are exact on doubles, and so is the
+                // truncated quotient
+                __m256i zero = _mm256_cmpeq_epi32(b, _mm256_setzero_si256());
+                e = avx2_set_error(e, zero, 7);
+                b = _mm256_blendv_epi8(b, _mm256_set1_epi32(1), zero);
+                __m128i q_lo = _mm256_cvttpd_epi32(_mm256_div_pd(
+                    _mm256_cvtepi32_pd(_mm256_castsi256_si128(a)),
+                    _mm256_cvtepi32_pd(_mm256_castsi256_si128(b))));
+                __m128i q_hi = _mm256_cvttpd_epi32(_mm256_div_pd(
+                    _mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1)),
+                    _mm256_cvtepi32_pd(_mm256_extracti128_si256(b, 1))));
+                r = _mm256_inserti128_si256(_mm256_castsi128_si256(q_lo), q_hi, 1);
+                if (_op == '%')
+                    r = _mm256_sub_epi32(a, _mm256_mullo_epi32(r, b));
+                break;
+            }
+        }
+        e = avx2_set_error(e, avx2_out_of_range(r), 8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(_rst + i), r);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(_errors + i), e);
+    }
+    apply_scalar(_op, _v1 + i, _v2 + i, _rst + i, _errors + i, _size - i);
+}
+
+
+// Verify which characters are in [_low, _low + _count)
+_SSE_ static inline __m128i sse_in(__m128i _c, char _low, char _count) {
+    __m128i _off = _mm_sub_epi8(_c, _mm_set1_epi8(_low));
+    return _mm_cmpeq_epi8(_mm_min_epu8(_off, _mm_set1_epi8(_count - 1)), _off);
+}
+
+// Verify the characters of a SSE block (see scan_scalar)
+_SSE_ static inline void sse_classify(__m128i _c, unsigned &_spaces,
+                                      unsigned &_digits, unsigned &_valid) {
+    __m128i _space = _mm_cmpeq_epi8(_c, _mm_set1_epi8(' '));
+    __m128i _digit = sse_in(_c, '0', 10);
+    __m128i _other = _mm_or_si128(
+        sse_in(_mm_or_si128(_c, _mm_set1_epi8(0x20)), 'a', 26),
+        _mm_cmpeq_epi8(_c, _mm_set1_epi8('_')));
+    // The symbols %, (, ), *, +, -, / and ^
+    _other = _mm_or_si128(_other, _mm_cmpeq_epi8(_c, _mm_set1_epi8('%')));
+    _other = _mm_or_si128(_other, sse_in(_c, '(', 4));
+    _other = _mm_or_si128(_other, _mm_cmpeq_epi8(_c, _mm_set1_epi8('-')));
+    _other = _mm_or_si128(_other, _mm_cmpeq_epi8(_c, _mm_set1_epi8('/')));
+    _other = _mm_or_si128(_other, _mm_cmpeq_epi8(_c, _mm_set1_epi8('^')));
+    _spaces = _mm_movemask_epi8(_space);
+    _digits = _mm_movemask_epi8(_digit);
+    _valid = _mm_movemask_epi8(_mm_or_si128(_other,
+                                            _mm_or_si128(_space, _digit)));
+}
+
+// SSE4.1 version
+_SSE_ static std::size_t scan_sse(const char *_text, std::size_t _size,
+                                  std::uint64_t *_starts) {
+    std::size_t _invalid = _size;
+    std::uint64_t _carry = 0;
+    auto _word(0u);
+    for (; (_word + 1) * 64 <= _size; _word++) {
+        std::uint64_t _spaces = 0, _digits = 0, _valid = 0;
+        for (auto k(0u); k < 4; k++) {
+            unsigned _s, _d, _v;
+            sse_classify(_mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                             _text + _word * 64 + k * 16)),
+                         _s, _d, _v);
+            _spaces |= std::uint64_t(_s) << (k * 16);
+            _digits |= std::uint64_t(_d) << (k * 16);
+            _valid |= std::uint64_t(_v) << (k * 16);
+        }
+        _starts[_word] = ~_spaces & ~(_digits & ((_digits << 1) | _carry));
+        _carry = _digits >> 63;
+        if (_invalid == _size && ~_valid != 0)
+            _invalid = _word * 64 + __builtin_ctzll(~_valid);
+    }
+    std::size_t _tail = scan_scalar(_text, _size, _starts, _word, _carry);
+    return _invalid < _size ? _invalid : _tail;
+}
+
+// Verify which characters are in [_low, _low + _count)
+_AVX2_ static inline __m256i avx2_in(__m256i _c, char _low, char _count) {
+    __m256i _off = _mm256_sub_epi8(_c, _mm256_set1_epi8(_low));
+    return _mm256_cmpeq_epi8(
+        _mm256_min_epu8(_off, _mm256_set1_epi8(_count - 1)), _off);
+}
+
+// Verify the characters of an AVX2 block (see scan_scalar)
+_AVX2_ static inline void avx2_classify(__m256i _c, std::uint32_t &_spaces,
+                                        std::uint32_t &_digits,
+                                        std::uint32_t &_valid) {
+    __m256i _space = _mm256_cmpeq_epi8(_c, _mm256_set1_epi8(' '));
+    __m256i _digit = avx2_in(_c, '0', 10);
+    __m256i _other = _mm256_or_si256(
+        avx2_in(_mm256_or_si256(_c, _mm256_set1_epi8(0x20)), 'a', 26),
+        _mm256_cmpeq_epi8(_c, _mm256_set1_epi8('_')));
+    // The symbols %, (, ), *, +, -, / and ^
+    _other = _mm256_or_si256(_other,
+                             _mm256_cmpeq_epi8(_c, _mm256_set1_epi8('%')));
+    _other = _mm256_or_si256(_other, avx2_in(_c, '(', 4));
+    _other = _mm256_or_si256(_other,
+                             _mm256_cmpeq_epi8(_c, _mm256_set1_epi8('-')));
+    _other = _mm256_or_si256(_other,
+                             _mm256_cmpeq_epi8(_c, _mm256_set1_epi8('/')));
+    _other = _mm256_or_si256(_other,
+                             _mm256_cmpeq_epi8(_c, _mm256_set1_epi8('^')));
+    _spaces = _mm256_movemask_epi8(_space);
+    _digits = _mm256_movemask_epi8(_digit);
+    _valid = _mm256_movemask_epi8(
+        _mm256_or_si256(_other, _mm256_or_si256(_space, _digit)));
+}
+
+// AVX2 version
+_AVX2_ static std::size_t scan_avx2(const char *_text, std::size_t _size,
+                                    std::uint64_t *_starts) {
+    std::size_t _invalid = _size;
+    std::uint64_t _carry = 0;
+    auto _word(0u);
+    for (; (_word + 1) * 64 <= _size; _word++) {
+        std::uint32_t _s[2], _d[2], _v[2];
+        for (auto k(0u); k < 2; k++)
+            avx2_classify(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+                              _text + _word * 64 + k * 32)),
+                          _s[k], _d[k], _v[k]);
+        std::uint64_t _spaces = _s[0] | std::uint64_t(_s[1]) << 32;
+        std::uint64_t _digits = _d[0] | std::uint64_t(_d[1]) << 32;
+        std::uint64_t _valid = _v[0] | std::uint64_t(_v[1]) << 32;
+        _starts[_word] = ~_spaces & ~(_digits & ((_digits << 1) | _carry));
+        _carry = _digits >> 63;
+        if (_invalid == _size && ~_valid != 0)
+            _invalid = _word * 64 + __builtin_ctzll(~_valid);
+    }
+    std::size_t _tail = scan_scalar(_text, _size, _starts, _word, _carry);
+    return _invalid < _size ? _invalid : _tail;
+}
+#endif
+
+// The instruction set in use
+static Kernels::Isa &current_isa() {
+    static Kernels::Isa _isa = Kernels::is_supported(Kernels::AVX2)
+        ? Kernels::AVX2
+        : Kernels::is_supported(Kernels::SSE) ? Kernels::SSE : Kernels::SCALAR;
+    return _isa;
+}
+
+// Gets the instruction set
+Kernels::Isa Kernels::isa() {
+    return current_isa();
+}
+
+// Verify if the instruction set is supported
+bool Kernels::is_supported(Isa _isa) {
+#if _KERNELS_X86_
+    switch (_isa) {
+        case AVX2:
+            return __builtin_cpu_supports("avx2");
+        case SSE:
+            return __builtin_cpu_supports("sse4.1");
+        default:
+            return true;
+    }
+#else
+    return _isa == SCALAR;
+#endif
+}
+
+// Select the instruction set
+bool Kernels::select(Isa _isa) {
+    if (!is_supported(_isa))
+        return false;
+    current_isa() = _isa;
+    return true;
+}
+
+// Apply an operator
+void Kernels::apply(int _op, const int *_v1, const int *_v2, int *_rst,
+                    int *_errors, unsigned _size) {
+#if _KERNELS_X86_
+    switch (current_isa()) {
+        case AVX2:
+            return apply_avx2(_op, _v1, _v2, _rst, _errors, _size);
+        case SSE:
+            return apply_sse(_op, _v1, _v2, _rst, _errors, _size);
+        default:
+            break;
+    }
+#endif
+    apply_scalar(_op, _v1, _v2, _rst, _errors, _size);
+}
+
+// Scan
+std::size_t Kernels::scan(const char *_text, std::size_t _size,
+                          std::uint64_t *_starts) {
+#if _KERNELS_X86_
+    switch (current_isa()) {
+        case AVX2:
+            return scan_avx2(_text, _size, _starts);
+        case SSE:
+            return scan_sse(_text, _size, _starts);
+        default:
+            break;
+    }
+#endif
+    return scan_scalar(_text, _size, _starts);
+}
@@ -12,15 +12,80 @@
  */
 
 #include <iostream>
-#include <fstream>
 #include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <limits>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include <unistd.h>
 
 #include "stack.hpp"
 #include "queue.hpp"
 #include "term.hpp"
 #include "errors.hpp"
 #include "expression.hpp"
+#include "driver.hpp"
+#include "input.hpp"
+#include "output.hpp"
+#include "perf_counters.hpp"
+#include "pipeline.hpp"
+#include "program_file.hpp"
+#include "result_cache.hpp"
+#include "server.hpp"
+
+//! The Server running (stopped by the signals)
+static Server *server = nullptr;
+
+/**
+ * @brief Stop the Server running
+ */
+static void stop_server(int) {
+    if (server != nullptr)
+        server->stop();
+}
+
+/**
+ * @brief Parse a number argument
+ * @param _arg The argument
+ * @param _return Keep the number
+ * @param _max The maximum number (default = the maximum of the type)
+ * @return True if the whole argument is a number up to the maximum, False
+ * otherwise
+ */
+template <typename T>
+static bool parse_number(const char *_arg, T &_return,
+                         unsigned long _max = std::numeric_limits<T>::max()) {
+    if (!std::isdigit(static_cast<unsigned char>(*_arg)))
+        return false;
+    char *_end;
+    errno = 0;
+    unsigned long _number = std::strtoul(_arg, &_end, 10);
+    if (*_end != '\0' || errno != 0 || _number > _max)
+        return false;
+    _return = _number;
+    return true;
+}
+
+/**
+ * @brief Print the usage
+ */
+static void usage() {
+    std::cerr
+        << "Usage: bares [-j N] [--cache N] [--share] [--perf-counters] "
+        << "input_file [output_file]\n"
+        << "       bares --stream [--cache N]\n"
+        << "       bares --server socket_path [--tcp PORT] [--cache N] "
+        << "[--share]\n"
+        << "       bares --compile-to compiled_file input_file\n"
+        << "       bares --load-compiled compiled_file [output_file]\n"
+        << "The input_file and output_file are on the data folder "
+        << "(compiled_file isn't).\n";
+}
 
 /**
  * @brief Main function
@@ -28,48 +93,191 @@
  * The main function, used to execute everything.
  */
 int main(int argc, char const *argv[]) {
-    std::ifstream input;
-    std::ofstream output;
-    std::ostream *out;
+    std::unique_ptr<Input> input;
+    std::unique_ptr<Output> output;
+    std::unique_ptr<ResultCache> cache;
+    std::unique_ptr<PerfCounters> counters;
+    bool written = false;
 
-    // Variables to file read
-    std::string line = "";
-    std::string result = "";
+    // Command line files and options
+    std::vector<std::string> files;
+    unsigned threads = 1;
+    std::size_t cache_size = 0;
+    bool share = false;
+    bool perf_counters = false;
+    bool stream = false;
+    std::string socket_path;
+    unsigned tcp_port = 0;
+    std::string compile_path;
+    std::string compiled_path;
 
-    if (argc >= 2) {
-        input.open("data/" + std::string(argv[1]));
-        // Verify if the files aren't opened
-        if (!input.is_open()) {
-            input.close();
-            goto open_failure;
+    for (auto i(1); i < argc; i++) {
+        std::string arg(argv[i]);
+        auto option = i;
+        if (arg == "-j" && i + 1 < argc && parse_number(argv[++i], threads))
+            continue;
+        else if (arg.compare(0, 2, "-j") == 0 && arg.size() > 2 &&
+                 parse_number(arg.c_str() + 2, threads))
+            continue;
+        else if (arg == "--cache" && i + 1 < argc &&
+                 parse_number(argv[++i], cache_size))
+            continue;
+        else if (arg == "--share")
+            share = true;
+        else if (arg == "--perf-counters")
+            perf_counters = true;
+        else if (arg == "--stream")
+            stream = true;
+        else if (arg == "--server" && i + 1 < argc)
+            socket_path = argv[++i];
+        else if (arg == "--tcp" && i + 1 < argc &&
+                 parse_number(argv[++i], tcp_port, 65535))
+            continue;
+        else if (arg == "--compile-to" && i + 1 < argc)
+            compile_path = argv[++i];
+        else if (arg == "--load-compiled" && i + 1 < argc)
+            compiled_path = argv[++i];
+        else if (arg.size() > 1 && arg[0] == '-') {
+            // An unknown option (or one with an invalid value, or without
+            // it) isn't a file name
+            std::cerr << "Invalid option: " << arg
+                      << (i > option ? " " + std::string(argv[i]) : "")
+                      << "\n";
+            usage();
+            return EXIT_FAILURE;
+        } else
+            files.push_back(arg);
+    }
+
+    // Serve the local clients until SIGINT or SIGTERM
+    if (!socket_path.empty() || tcp_port > 0) {
+        if (cache_size > 0)
+            cache.reset(new ResultCache(cache_size));
+        Server local(cache.get(), share);
+        if ((!socket_path.empty() && !local.listen_unix(socket_path)) ||
+            (tcp_port > 0 && !local.listen_tcp(tcp_port))) {
+            std::cerr << "The socket specified cannot be opened.\n";
+            return EXIT_FAILURE;
+        }
+        server = &local;
+        std::signal(SIGINT, stop_server);
+        std::signal(SIGTERM, stop_server);
+        bool stopped = local.run();
+        server = nullptr;
+        local.report(std::cerr);
+        if (cache)
+            std::cerr << "Cache: " << cache->hits() << " hits, "
+                      << cache->misses() << " misses\n";
+        return stopped ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Stream the standard input to the standard output, by stages
+    if (stream) {
+        if (cache_size > 0)
+            cache.reset(new ResultCache(cache_size));
+        Pipeline pipeline(cache.get());
+        written = pipeline.run(STDIN_FILENO, STDOUT_FILENO);
+        if (cache)
+            std::cerr << "Cache: " << cache->hits() << " hits, "
+                      << cache->misses() << " misses\n";
+        if (pipeline.read_failed())
+            goto read_failure;
+        if (!written) {
+            std::cerr << "The results cannot be written.\n";
+            return EXIT_FAILURE;
         }
-        if (argc == 2) {
-            out = &std::cout;
+        return EXIT_SUCCESS;
+    }
+
+    // Evaluate the Programs compiled on a previous run, without parsing
+    if (!compiled_path.empty()) {
+        ProgramFile compiled(compiled_path);
+        switch (compiled.status()) {
+            case ProgramFile::OK:
+                break;
+            case ProgramFile::CANNOT_OPEN:
+                goto open_failure;
+            case ProgramFile::BAD_VERSION:
+                std::cerr << "The compiled file has another version.\n";
+                return EXIT_FAILURE;
+            default:
+                std::cerr << "The compiled file is corrupted.\n";
+                return EXIT_FAILURE;
+        }
+        if (files.empty()) {
+            output.reset(new Output(STDOUT_FILENO));
         } else {
-            output.open("data/" + std::string(argv[2]));
-            if (!output.is_open()) {
-                output.close();
+            output.reset(new Output("data/" + files[0]));
+            if (!output->good())
                 goto open_failure;
-            }
-            out = &output;
         }
+        Result result;
+        for (std::size_t p = 0; p < compiled.size(); p++) {
+            compiled.eval(p, result);
+            output->write(result);
+        }
+        return output->flush() && output->good() ? EXIT_SUCCESS
+                                                 : EXIT_FAILURE;
+    }
+
+    if (files.size() >= 1) {
+        input.reset(new Input("data/" + files[0]));
+        // Verify if the files aren't opened
+        if (!input->is_open())
+            goto open_failure;
     } else {
         std::cerr << "No input file specified. Finishing execution.\n";
         return EXIT_FAILURE;
     }
 
-    while (std::getline(input, line)) {
-        Expression expr(line);
-        expr.calculate(result);
-        *out << result << "\n";
+    // Compile all lines for the next runs, instead of evaluating them
+    if (!compile_path.empty()) {
+        if (!ProgramFile::write(compile_path, *input)) {
+            if (!input->good())
+                goto read_failure;
+            goto open_failure;
+        }
+        return EXIT_SUCCESS;
     }
 
-    // Close Opened files
-    input.close();
-    output.close();
+    // Evaluate all lines (on many threads and with a cache, if asked)
+    if (files.size() == 1) {
+        output.reset(new Output(STDOUT_FILENO));
+    } else {
+        output.reset(new Output("data/" + files[1]));
+        if (!output->good())
+            goto open_failure;
+    }
+    if (cache_size > 0)
+        cache.reset(new ResultCache(cache_size));
+    if (perf_counters) {
+        counters.reset(new PerfCounters);
+        if (!counters->available())
+            std::cerr << "Perf counters not available, measuring the time "
+                      << "only.\n";
+    }
+    written =
+        Driver(threads, cache.get(), share, counters.get()).run(*input, *output);
+
+    if (cache)
+        std::cerr << "Cache: " << cache->hits() << " hits, "
+                  << cache->misses() << " misses\n";
+    if (counters)
+        counters->report(std::cerr);
+    if (!input->good())
+        goto read_failure;
+    if (!written) {
+        std::cerr << "The results cannot be written.\n";
+        return EXIT_FAILURE;
+    }
 
     return EXIT_SUCCESS;
 
+    read_failure: {
+        std::cerr << "The file specified cannot be read.\n";
+        return EXIT_FAILURE;
+    }
+
     open_failure: {
         std::cerr << "The file specified cannot be opened.\n";
         return EXIT_FAILURE;
@@ -0,0 +1,148 @@
+/*!
+ *  @file output.cpp
+ *  @brief Output Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with Output Class implementations
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "errors.hpp"
+#include "output.hpp"
+#include "result.hpp"
+
+// All two digits numbers, to format an integer two digits at a time
+static const char DIGITS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// The longest line (defined here too, as it's also bound to references,
+// e.g. by std::max)
+const std::size_t Output::MAX_LINE;
+
+// Constructor (file path)
+Output::Output(const std::string &_path, std::size_t _capacity)
+    : m_buffer(_capacity) {
+    m_fd = open(_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    m_owns_fd = m_good = m_fd >= 0;
+}
+
+// Constructor (file descriptor)
+Output::Output(int _fd, std::size_t _capacity)
+    : m_fd(_fd), m_good(_fd >= 0), m_buffer(_capacity) {}
+
+// Destructor
+Output::~Output() {
+    flush();
+    if (m_owns_fd)
+        close(m_fd);
+}
+
+// Verify if is good
+bool Output::good() const {
+    return m_good;
+}
+
+// Write a Result
+void Output::write(const Result &_result) {
+    if (m_buffer.size() - m_size < MAX_LINE)
+        flush();
+    if (m_buffer.size() - m_size < MAX_LINE) {
+        char _line[MAX_LINE];
+        write(std::string_view(_line, format(_result, _line) - _line));
+        return;
+    }
+    m_size = format(_result, m_buffer.data() + m_size) - m_buffer.data();
+}
+
+// Write a text
+void Output::write(std::string_view _text) {
+    if (m_buffer.size() - m_size < _text.size())
+        flush();
+    // A text bigger than the buffer goes straight to the file
+    if (m_buffer.size() < _text.size()) {
+        m_good = write_all(_text.data(), _text.size()) && m_good;
+        return;
+    }
+    std::memcpy(m_buffer.data() + m_size, _text.data(), _text.size());
+    m_size += _text.size();
+}
+
+// Flush
+bool Output::flush() {
+    if (m_size > 0)
+        m_good = write_all(m_buffer.data(), m_size) && m_good;
+    m_size = 0;
+    return m_good;
+}
+
+// Format a Result
+char *Output::format(const Result &_result, char *_dst) {
+    if (_result.is_error()) {
+        auto _prefix = Errors::get_error_prefix(_result.error);
+        _dst = std::copy(_prefix.begin(), _prefix.end(), _dst);
+        if (Errors::has_column(_result.error)) {
+            _dst = format_integer(_result.col + 1, _dst);
+            auto _suffix = Errors::get_error_suffix(_result.error);
+            _dst = std::copy(_suffix.begin(), _suffix.end(), _dst);
+        }
+    } else if (!_result.empty) {
+        _dst = std::fill_n(_dst, _result.zeros, '0');
+        _dst = format_integer(_result.value, _dst);
+    }
+    *_dst++ = '\n';
+    return _dst;
+}
+
+// Format an integer
+char *Output::format_integer(long long _value, char *_dst) {
+    unsigned long long _abs = _value;
+    if (_value < 0) {
+        *_dst++ = '-';
+        _abs = 0 - _abs;
+    }
+
+    // Write the digits backwards on a temporary, two at a time
+    char _digits[20];
+    char *_end = _digits + sizeof(_digits), *_p = _end;
+    while (_abs >= 100) {
+        auto _i = (_abs % 100) * 2;
+        _abs /= 100;
+        *--_p = DIGITS[_i + 1];
+        *--_p = DIGITS[_i];
+    }
+    if (_abs >= 10) {
+        *--_p = DIGITS[_abs * 2 + 1];
+        *--_p = DIGITS[_abs * 2];
+    } else {
+        *--_p = '0' + _abs;
+    }
+
+    return std::copy(_p, _end, _dst);
+}
+
+// Write all bytes
+bool Output::write_all(const char *_data, std::size_t _size) {
+    if (m_fd < 0)
+        return false;
+    while (_size > 0) {
+        ssize_t _written = ::write(m_fd, _data, _size);
+        if (_written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        _data += _written;
+        _size -= _written;
+    }
+    return true;
+}
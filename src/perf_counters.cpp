@@ -0,0 +1,150 @@
+/*!
+ *  @file perf_counters.cpp
+ *  @brief PerfCounters Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with PerfCounters Class implementations
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+#include "perf_counters.hpp"
+
+#if defined(__linux__)
+#define _PERF_COUNTERS_ 1
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#define _PERF_COUNTERS_ 0
+#endif
+
+#if _PERF_COUNTERS_
+// Open a counter of the calling thread (on the group of _leader, if >= 0)
+static int open_counter(std::uint64_t _config, int _leader) {
+    perf_event_attr _attr;
+    std::memset(&_attr, 0, sizeof(_attr));
+    _attr.size           = sizeof(_attr);
+    _attr.type           = PERF_TYPE_HARDWARE;
+    _attr.config         = _config;
+    _attr.disabled       = _leader < 0;
+    _attr.exclude_kernel = 1;
+    _attr.exclude_hv     = 1;
+    _attr.read_format    = PERF_FORMAT_GROUP;
+    return syscall(SYS_perf_event_open, &_attr, 0, -1, _leader, 0);
+}
+#endif
+
+// Constructor
+PerfCounters::PerfCounters() {
+    for (auto &_fd : m_fds)
+        _fd = -1;
+#if _PERF_COUNTERS_
+    static const std::uint64_t configs[] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES};
+    for (auto i(0); i < COUNTERS; i++) {
+        m_fds[i] = open_counter(configs[i], m_fds[0]);
+        // All counters are measured together, or none is
+        if (m_fds[i] < 0)
+            return;
+    }
+    m_available = ioctl(m_fds[0], PERF_EVENT_IOC_ENABLE,
+                        PERF_IOC_FLAG_GROUP) == 0;
+#endif
+}
+
+// Destructor
+PerfCounters::~PerfCounters() {
+#if _PERF_COUNTERS_
+    for (auto _fd : m_fds)
+        if (_fd >= 0)
+            close(_fd);
+#endif
+}
+
+// Counters available
+bool PerfCounters::available() const {
+    return m_available;
+}
+
+// Start a phase
+void PerfCounters::start(Phase _phase) {
+    if (m_available)
+        read(m_start);
+    Profiler::start(_phase);
+}
+
+// Stop a phase
+void PerfCounters::stop(Phase _phase) {
+    Profiler::stop(_phase);
+    std::uint64_t _values[COUNTERS];
+    if (m_available && read(_values))
+        for (auto i(0); i < COUNTERS; i++)
+            m_values[_phase][i] += _values[i] - m_start[i];
+}
+
+// Counter value
+std::uint64_t PerfCounters::value(Phase _phase, Counter _counter) const {
+    return m_values[_phase][_counter];
+}
+
+// Counter name
+const char *PerfCounters::name(Counter _counter) {
+    static const char *names[] = {"cycles", "instructions", "branch_misses",
+                                  "cache_misses"};
+    return _counter < COUNTERS ? names[_counter] : "";
+}
+
+// Report
+void PerfCounters::report(std::ostream &_out) const {
+    _out << "phase,count,seconds";
+    for (auto i(0); i < COUNTERS; i++)
+        _out << "," << name(static_cast<Counter>(i));
+    _out << "\n";
+
+    std::uint64_t _total[2 + COUNTERS] = {};
+    for (auto p(0); p <= PHASES; p++) {
+        // The last row is the total of all phases
+        std::uint64_t _row[2 + COUNTERS] = {};
+        if (p < PHASES) {
+            auto _phase = static_cast<Phase>(p);
+            _row[0] = count(_phase);
+            _row[1] = nanoseconds(_phase);
+            for (auto i(0); i < COUNTERS; i++)
+                _row[2 + i] = m_values[p][i];
+            for (auto i(0); i < 2 + COUNTERS; i++)
+                _total[i] += _row[i];
+        } else {
+            std::memcpy(_row, _total, sizeof(_row));
+        }
+
+        _out << (p < PHASES ? Profiler::name(static_cast<Phase>(p)) : "total")
+             << "," << _row[0] << "," << _row[1] / 1e9;
+        for (auto i(0); i < COUNTERS; i++) {
+            if (m_available)
+                _out << "," << _row[2 + i];
+            else
+                _out << ",-";
+        }
+        _out << "\n";
+    }
+}
+
+// Read the counters
+bool PerfCounters::read(std::uint64_t *_values) const {
+#if _PERF_COUNTERS_
+    // The group is read at once: the number of counters and their values
+    std::uint64_t _group[1 + COUNTERS];
+    if (::read(m_fds[0], _group, sizeof(_group)) != sizeof(_group))
+        return false;
+    std::memcpy(_values, _group + 1, sizeof(std::uint64_t) * COUNTERS);
+    return true;
+#else
+    (void)_values;
+    return false;
+#endif
+}
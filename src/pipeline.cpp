@@ -0,0 +1,175 @@
+/*!
+ *  @file pipeline.cpp
+ *  @brief Pipeline Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with Pipeline Class implementations
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+#include <unistd.h>
+
+#include "output.hpp"
+#include "pipeline.hpp"
+
+// Constructor
+Pipeline::Pipeline(ResultCache *_cache, unsigned _blocks,
+                   std::size_t _block_size)
+    : m_cache(_cache), m_lines(std::max(_blocks, 2u)),
+      m_results(std::max(_blocks, 2u)), m_read(m_lines.size() + 1),
+      m_free_lines(m_lines.size()), m_evaluated(m_results.size() + 1),
+      m_free_results(m_results.size()) {
+    for (auto &_block : m_lines)
+        _block.data.resize(std::max<std::size_t>(_block_size, 1));
+    // A block of results has room for at least one result
+    for (auto &_block : m_results)
+        _block.data.resize(std::max(_block_size, Output::MAX_LINE));
+}
+
+// Run
+bool Pipeline::run(int _in, int _out) {
+    // All blocks start free (a previous run may have kept some)
+    Block *_block;
+    while (m_free_lines.try_pop(_block)) {}
+    while (m_free_results.try_pop(_block)) {}
+    for (auto &_lines : m_lines)
+        m_free_lines.push(&_lines);
+    for (auto &_results : m_results)
+        m_free_results.push(&_results);
+    m_good = true;
+    m_read_failed = false;
+
+    std::thread reader(&Pipeline::read, this, _in);
+    std::thread writer(&Pipeline::write, this, _out);
+    evaluate();
+    reader.join();
+    writer.join();
+    return m_good && !m_read_failed;
+}
+
+// Verify if a read failed
+bool Pipeline::read_failed() const {
+    return m_read_failed;
+}
+
+// Reader stage
+void Pipeline::read(int _in) {
+    Block *_block, *_next;
+    m_free_lines.pop(_block);
+    _block->size = 0;
+
+    while (true) {
+        // Grow if the line doesn't fit
+        if (_block->size == _block->data.size())
+            _block->data.resize(_block->data.size() * 2);
+
+        char *_begin = _block->data.data();
+        ssize_t _read;
+        do {
+            _read = ::read(_in, _begin + _block->size,
+                           _block->data.size() - _block->size);
+        } while (_read < 0 && errno == EINTR);
+        // A failed read isn't the end of the input (e.g. a directory)
+        if (_read < 0)
+            m_read_failed = true;
+        if (_read <= 0)
+            break;
+
+        // Send the whole lines as soon as they're read, and move the
+        // incomplete one to the next block
+        const char *_old = _begin + _block->size;
+        _block->size += _read;
+        const char *_nl = _begin + _block->size;
+        while (_nl != _old && _nl[-1] != '\n')
+            _nl--;
+        if (_nl == _old)
+            continue;
+
+        m_free_lines.pop(_next);
+        _next->size = _begin + _block->size - _nl;
+        if (_next->data.size() < _next->size)
+            _next->data.resize(_block->data.size());
+        std::memcpy(_next->data.data(), _nl, _next->size);
+        _block->size = _nl - _begin;
+        m_read.push(_block);
+        _block = _next;
+    }
+
+    // The last line may have no line break
+    if (_block->size > 0)
+        m_read.push(_block);
+    m_read.push(nullptr);
+}
+
+// Evaluator stage
+void Pipeline::evaluate() {
+    Block *_lines, *_results;
+    m_free_results.pop(_results);
+    _results->size = 0;
+
+    for (m_read.pop(_lines); _lines != nullptr; m_read.pop(_lines)) {
+        const char *_begin = _lines->data.data();
+        const char *_end = _begin + _lines->size;
+        while (_begin < _end) {
+            auto _nl = static_cast<const char *>(
+                std::memchr(_begin, '\n', _end - _begin));
+            const char *_stop = _nl != nullptr ? _nl : _end;
+            calculate(std::string_view(_begin, _stop - _begin), m_result);
+
+            if (_results->data.size() - _results->size < Output::MAX_LINE) {
+                m_evaluated.push(_results);
+                m_free_results.pop(_results);
+                _results->size = 0;
+            }
+            char *_dst = _results->data.data();
+            _results->size =
+                Output::format(m_result, _dst + _results->size) - _dst;
+            _begin = _stop + 1;
+        }
+        m_free_lines.push(_lines);
+
+        // The results of each block are written without waiting for more
+        if (_results->size > 0) {
+            m_evaluated.push(_results);
+            m_free_results.pop(_results);
+            _results->size = 0;
+        }
+    }
+    m_evaluated.push(nullptr);
+}
+
+// Writer stage
+void Pipeline::write(int _out) {
+    Block *_block;
+    for (m_evaluated.pop(_block); _block != nullptr; m_evaluated.pop(_block)) {
+        const char *_data = _block->data.data();
+        std::size_t _size = _block->size;
+        while (m_good && _size > 0) {
+            ssize_t _written = ::write(_out, _data, _size);
+            if (_written < 0 && errno == EINTR)
+                continue;
+            if (_written <= 0) {
+                m_good = false;
+                break;
+            }
+            _data += _written;
+            _size -= _written;
+        }
+        m_free_results.push(_block);
+    }
+}
+
+// Evaluate a line
+void Pipeline::calculate(std::string_view _expr, Result &_return) {
+    if (m_cache != nullptr && m_cache->find(_expr, _return))
+        return;
+    m_expr.reset(_expr);
+    m_expr.calculate(_return);
+    if (m_cache != nullptr)
+        m_cache->insert(_expr, _return);
+}
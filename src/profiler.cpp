@@ -0,0 +1,46 @@
+/*!
+ *  @file profiler.cpp
+ *  @brief Profiler Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with Profiler Class implementations
+ */
+
+#include <chrono>
+#include <cstdint>
+
+#include "profiler.hpp"
+
+// Destructor
+Profiler::~Profiler() {}
+
+// Start a phase
+void Profiler::start(Phase) {
+    m_start = std::chrono::steady_clock::now();
+}
+
+// Stop a phase
+void Profiler::stop(Phase _phase) {
+    auto _elapsed = std::chrono::steady_clock::now() - m_start;
+    m_nanoseconds[_phase] +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(_elapsed)
+            .count();
+    m_count[_phase]++;
+}
+
+// Phase time
+std::uint64_t Profiler::nanoseconds(Phase _phase) const {
+    return m_nanoseconds[_phase];
+}
+
+// Phase measures
+std::uint64_t Profiler::count(Phase _phase) const {
+    return m_count[_phase];
+}
+
+// Phase name
+const char *Profiler::name(Phase _phase) {
+    static const char *names[] = {"tokenize", "infix2postfix", "get_result",
+                                  "output"};
+    return _phase < PHASES ? names[_phase] : "";
+}
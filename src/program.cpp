@@ -0,0 +1,213 @@
+/*!
+ *  @file program.cpp
+ *  @brief Program Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with Program Class implementations
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "arithmetic.hpp"
+#include "errors.hpp"
+#include "kernels.hpp"
+#include "program.hpp"
+#include "result.hpp"
+#include "stack.hpp"
+
+// Evaluate
+bool Program::eval(int &_return, int &_error) const {
+    return eval(nullptr, _return, _error);
+}
+
+// Evaluate with variables
+bool Program::eval(const int *_variables, int &_return, int &_error) const {
+    if (!is_valid()) {
+        _error = m_error.id;
+        return false;
+    }
+    return eval(m_program.data(), m_program.size(), m_depth, _variables,
+                _return, _error);
+}
+
+// Evaluate in place
+bool Program::eval(const Instruction *_program, std::size_t _size,
+                   unsigned _depth, const int *_variables, int &_return,
+                   int &_error, std::size_t *_failed) {
+    // Usual depths fit on the Stack inline buffer, without allocating
+    Stack<int, 16> operands(_depth);
+    // The last operands taken from the Stack (see Expression::Operands)
+    int lhs = 0, rhs = 0;
+
+    for (std::size_t i = 0; i < _size; i++) {
+        const Instruction &_i = _program[i];
+        bool _succeed = true;
+        switch (_i.op) {
+            case PUSH:
+                operands.push(_i.value);
+                continue;
+            case LOAD:
+                if (!Arithmetic::is_valid_number(_variables[_i.value])) {
+                    _error = 8;
+                    _succeed = false;
+                    break;
+                }
+                operands.push(_variables[_i.value]);
+                continue;
+            case NEG:
+                operands.pop(rhs);
+                lhs = 0;
+                _succeed = Arithmetic::apply(SUB, lhs, rhs, rhs, _error);
+                break;
+            default:
+                operands.pop(rhs);
+                operands.pop(lhs);
+                _succeed = Arithmetic::apply(_i.op, lhs, rhs, rhs, _error);
+                break;
+        }
+        if (!_succeed) {
+            if (_failed != nullptr)
+                *_failed = i;
+            return false;
+        }
+        operands.push(rhs);
+    }
+
+    _return = 0;
+    operands.pop(_return);
+    return true;
+}
+
+// Evaluate over many rows
+void Program::eval_batch(const int *const *_columns, unsigned _size,
+                         int *_return, int *_errors) const {
+    // An operator that finds the Stack empty depends on the previous
+    // operands of its own row, so these Programs are evaluated row by row
+    if (!is_valid() || !m_balanced || empty()) {
+        std::vector<int> _row(m_variables);
+        for (auto i(0u); i < _size; i++) {
+            for (auto k(0u); k < m_variables; k++)
+                _row[k] = _columns[k][i];
+            _errors[i] = -1;
+            if (!eval(_row.data(), _return[i], _errors[i]))
+                _return[i] = 0;
+        }
+        return;
+    }
+
+    // The operands Stack keeps a block of rows on each position
+    const unsigned _block = 256;
+    std::vector<int> _stack(m_depth * _block), _zeros(_block, 0);
+
+    for (auto _row(0u); _row < _size; _row += _block) {
+        unsigned n = std::min(_block, _size - _row);
+        int *e = _errors + _row;
+        int *top = _stack.data();
+        std::fill_n(e, n, -1);
+
+        for (const auto &_i : m_program) {
+            switch (_i.op) {
+                case PUSH:
+                    std::fill_n(top, n, _i.value);
+                    top += _block;
+                    break;
+                case LOAD:
+                    // Adding 0 verifies if the value is in range
+                    Kernels::apply(ADD, _columns[_i.value] + _row,
+                                   _zeros.data(), top, e, n);
+                    top += _block;
+                    break;
+                case NEG:
+                    Kernels::apply(SUB, _zeros.data(), top - _block,
+                                   top - _block, e, n);
+                    break;
+                default:
+                    top -= _block;
+                    Kernels::apply(_i.op, top - _block, top, top - _block,
+                                   e, n);
+                    break;
+            }
+        }
+
+        // The result is on the top (operands may remain below it, e.g. "2(3)")
+        top -= _block;
+        for (auto i(0u); i < n; i++)
+            _return[_row + i] = e[i] == -1 ? top[i] : 0;
+    }
+}
+
+// Evaluate to a Result
+bool Program::eval(Result &_return) const {
+    _return = Result();
+    if (!eval(_return.value, _return.error)) {
+        _return.value = 0;
+        _return.col   = is_valid() ? -1 : m_error.col;
+        return false;
+    }
+
+    // An empty Program has an empty result
+    _return.empty = empty();
+    _return.zeros = m_zeros;
+    return true;
+}
+
+// Evaluate to string
+bool Program::eval(std::string &_return) const {
+    Result result;
+    if (!eval(result)) {
+        _return = Errors::get_error_message(result.error, result.col);
+        return false;
+    }
+
+    _return = result.empty ? ""
+                           : std::string(result.zeros, '0') +
+                                 std::to_string(result.value);
+    return true;
+}
+
+// Verify if was compiled
+bool Program::is_valid() const {
+    return m_error.id == -1;
+}
+
+// Verify if is empty
+bool Program::empty() const {
+    return m_program.empty();
+}
+
+// Gets the number of variables
+unsigned Program::variables() const {
+    return m_variables;
+}
+
+// Gets the operands Stack max size
+unsigned Program::depth() const {
+    return m_depth;
+}
+
+// Gets the value leading zeros
+int Program::zeros() const {
+    return m_zeros;
+}
+
+// Gets the instructions
+const std::vector<Program::Instruction> &Program::instructions() const {
+    return m_program;
+}
+
+// Gets the instructions columns
+const std::vector<int> &Program::columns() const {
+    return m_columns;
+}
+
+// Gets the compilation error id
+int Program::error_id() const {
+    return m_error.id;
+}
+
+// Gets the compilation error column
+int Program::error_col() const {
+    return m_error.col;
+}
@@ -0,0 +1,288 @@
+/*!
+ *  @file program_file.cpp
+ *  @brief Program File Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with Program File Class implementations
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "expression.hpp"
+#include "output.hpp"
+#include "program_file.hpp"
+
+/**
+ * @brief The file header
+ */
+struct ProgramFile::Header {
+    char magic[8];             //!< The file type ("BARESPRG")
+    std::uint32_t version;     //!< The format version
+    std::uint32_t byte_order;  //!< ORDER_MARK, as the machine writes it
+    std::uint64_t programs;    //!< The number of Programs
+    std::uint64_t index;       //!< The index position
+    std::uint64_t size;        //!< The file size
+    std::uint64_t checksum;    //!< The checksum of all bytes after the header
+    std::uint64_t reserved[2];  //!< Zeros
+};
+
+/**
+ * @brief The record of a Program
+ *
+ * Followed by its instructions and by their columns (padded to 8 bytes)
+ */
+struct ProgramFile::Record {
+    std::int32_t error;          //!< The compilation error id (or -1)
+    std::int32_t col;            //!< The compilation error column (or -1)
+    std::uint32_t depth;         //!< The operands Stack max size
+    std::uint32_t instructions;  //!< The number of instructions
+    std::int32_t zeros;          //!< The value leading zeros
+    std::int32_t reserved;       //!< Zero
+};
+
+// The instructions are used straight from the mapping
+static_assert(sizeof(Program::Instruction) == 8 &&
+                  offsetof(Program::Instruction, value) == 4,
+              "Unexpected Program::Instruction layout");
+
+// The file type
+static const char MAGIC[8] = {'B', 'A', 'R', 'E', 'S', 'P', 'R', 'G'};
+// Read as another number by a machine with another byte order
+static const std::uint32_t ORDER_MARK = 0x01020304;
+
+/**
+ * @brief Round a size up to a multiple of 8 bytes
+ * @param _size The size
+ * @return The rounded size
+ */
+static std::size_t align(std::size_t _size) {
+    return (_size + 7) & ~static_cast<std::size_t>(7);
+}
+
+/**
+ * @brief Calculate the checksum of a sequence of 8-byte words
+ * @param _data The words (8-byte aligned)
+ * @param _size The number of bytes (a multiple of 8)
+ * @return The checksum (FNV-1a, a word at a time)
+ */
+static std::uint64_t checksum(const char *_data, std::size_t _size) {
+    std::uint64_t _hash = 14695981039346656037ull;
+    for (std::size_t i = 0; i < _size; i += 8) {
+        std::uint64_t _word;
+        std::memcpy(&_word, _data + i, 8);
+        _hash = (_hash ^ _word) * 1099511628211ull;
+    }
+    return _hash;
+}
+
+/**
+ * @brief Append the bytes of an object to a buffer
+ * @param _object The object
+ * @param _size The number of bytes
+ * @param _return The buffer
+ */
+static void append(const void *_object, std::size_t _size,
+                   std::vector<char> &_return) {
+    auto _bytes = static_cast<const char *>(_object);
+    _return.insert(_return.end(), _bytes, _bytes + _size);
+}
+
+// Constructor
+ProgramFile::ProgramFile(const std::string &_path) {
+    m_fd = open(_path.c_str(), O_RDONLY);
+    if (m_fd < 0)
+        return;
+
+    struct stat _stat;
+    if (fstat(m_fd, &_stat) != 0 || !S_ISREG(_stat.st_mode))
+        return;
+    m_size = _stat.st_size;
+    if (m_size < sizeof(Header)) {
+        m_status = BAD_FORMAT;
+        return;
+    }
+    void *_map = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (_map == MAP_FAILED) {
+        m_size = 0;
+        return;
+    }
+    m_data = static_cast<const char *>(_map);
+    m_status = verify();
+}
+
+// Destructor
+ProgramFile::~ProgramFile() {
+    if (m_data != nullptr)
+        munmap(const_cast<char *>(m_data), m_size);
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+// Gets the load status
+ProgramFile::Status ProgramFile::status() const {
+    return m_status;
+}
+
+// Gets the number of Programs
+std::size_t ProgramFile::size() const {
+    if (m_status != OK)
+        return 0;
+    return reinterpret_cast<const Header *>(m_data)->programs;
+}
+
+// Evaluate a Program
+bool ProgramFile::eval(std::size_t _index, Result &_return,
+                       int *_column) const {
+    const Record *_record = record(_index);
+    _return = Result();
+    if (_record->error >= 0) {
+        _return.error = _record->error;
+        _return.col = _record->col;
+        if (_column != nullptr)
+            *_column = _record->col;
+        return false;
+    }
+
+    auto _program = reinterpret_cast<const Program::Instruction *>(_record + 1);
+    std::size_t _failed;
+    if (!Program::eval(_program, _record->instructions, _record->depth,
+                       nullptr, _return.value, _return.error, &_failed)) {
+        _return.value = 0;
+        if (_column != nullptr)
+            *_column = reinterpret_cast<const std::int32_t *>(
+                _program + _record->instructions)[_failed];
+        return false;
+    }
+    _return.empty = _record->instructions == 0;
+    _return.zeros = _record->zeros;
+    return true;
+}
+
+// Compile to a file
+bool ProgramFile::write(const std::string &_path, Input &_input) {
+    std::vector<char> _body;
+    std::vector<std::uint64_t> _index;
+    Expression _expr{std::string_view()};
+    Program _program;
+    std::string_view _line;
+
+    while (_input.next(_line)) {
+        _index.push_back(sizeof(Header) + _body.size());
+        _expr.reset(_line);
+        _expr.compile(_program);
+
+        Record _record = {_program.error_id(), _program.error_col(),
+                          _program.depth(),
+                          static_cast<std::uint32_t>(
+                              _program.instructions().size()),
+                          _program.zeros(), 0};
+        append(&_record, sizeof(_record), _body);
+        // Field by field over zeros, so the padding of each instruction is
+        // written as zeros too (the same input gives the same file)
+        std::size_t _at = _body.size();
+        _body.resize(_at + _record.instructions * sizeof(Program::Instruction));
+        for (const auto &_instruction : _program.instructions()) {
+            std::memcpy(&_body[_at], &_instruction.op, sizeof(_instruction.op));
+            std::memcpy(&_body[_at + offsetof(Program::Instruction, value)],
+                        &_instruction.value, sizeof(_instruction.value));
+            _at += sizeof(Program::Instruction);
+        }
+        append(_program.columns().data(),
+               _record.instructions * sizeof(std::int32_t), _body);
+        _body.resize(align(_body.size()));
+    }
+    // A partial input isn't compiled
+    if (!_input.good())
+        return false;
+    append(_index.data(), _index.size() * sizeof(std::uint64_t), _body);
+
+    Header _header = {};
+    std::memcpy(_header.magic, MAGIC, sizeof(MAGIC));
+    _header.version = VERSION;
+    _header.byte_order = ORDER_MARK;
+    _header.programs = _index.size();
+    _header.index = sizeof(Header) + _body.size() -
+                    _index.size() * sizeof(std::uint64_t);
+    _header.size = sizeof(Header) + _body.size();
+    _header.checksum = checksum(_body.data(), _body.size());
+
+    Output _file(_path);
+    _file.write(std::string_view(reinterpret_cast<const char *>(&_header),
+                                 sizeof(_header)));
+    _file.write(std::string_view(_body.data(), _body.size()));
+    return _file.flush() && _file.good();
+}
+
+// Verify the mapping
+ProgramFile::Status ProgramFile::verify() const {
+    auto _header = reinterpret_cast<const Header *>(m_data);
+    if (std::memcmp(_header->magic, MAGIC, sizeof(MAGIC)) != 0)
+        return BAD_FORMAT;
+    if (_header->byte_order != ORDER_MARK || _header->version != VERSION)
+        return BAD_VERSION;
+    if (_header->size != m_size || m_size % 8 != 0 ||
+        _header->index < sizeof(Header) || _header->index > m_size ||
+        _header->programs != (m_size - _header->index) / 8 ||
+        _header->index % 8 != 0)
+        return BAD_FORMAT;
+    if (_header->checksum !=
+        checksum(m_data + sizeof(Header), m_size - sizeof(Header)))
+        return BAD_CHECKSUM;
+
+    // All records must fit before the index, with the opcodes known (and
+    // without variables, which can't be given), and a constant has up to 6
+    // characters (see Lexer), so up to 5 leading zeros
+    auto _index = reinterpret_cast<const std::uint64_t *>(m_data +
+                                                          _header->index);
+    for (std::uint64_t i = 0; i < _header->programs; i++) {
+        std::uint64_t _offset = _index[i];
+        if (_offset < sizeof(Header) || _offset % 8 != 0 ||
+            _header->index - _offset < sizeof(Record))
+            return BAD_FORMAT;
+        auto _record = reinterpret_cast<const Record *>(m_data + _offset);
+        std::uint64_t _size = _record->instructions;
+        if (_header->index - _offset - sizeof(Record) <
+                align(_size * (sizeof(Program::Instruction) + 4)) ||
+            _record->depth > _size || _record->error < -1 ||
+            _record->error > 8 || _record->zeros < 0 ||
+            _record->zeros > 5)
+            return BAD_FORMAT;
+
+        auto _program = reinterpret_cast<const Program::Instruction *>(
+            _record + 1);
+        for (std::uint64_t j = 0; j < _size; j++) {
+            switch (_program[j].op) {
+                case Program::PUSH:
+                case Program::NEG:
+                case Program::ADD:
+                case Program::SUB:
+                case Program::MUL:
+                case Program::DIV:
+                case Program::MOD:
+                case Program::POW:
+                    continue;
+                default:
+                    return BAD_FORMAT;
+            }
+        }
+    }
+    return OK;
+}
+
+// Gets a record
+const ProgramFile::Record *ProgramFile::record(std::size_t _index) const {
+    auto _header = reinterpret_cast<const Header *>(m_data);
+    auto _offsets = reinterpret_cast<const std::uint64_t *>(m_data +
+                                                            _header->index);
+    return reinterpret_cast<const Record *>(m_data + _offsets[_index]);
+}
@@ -0,0 +1,126 @@
+/*!
+ *  @file result_cache.cpp
+ *  @brief ResultCache Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with ResultCache Class implementations
+ */
+
+#include <cstring>
+#include <mutex>
+#include <string_view>
+
+#include "result.hpp"
+#include "result_cache.hpp"
+
+// Constructor
+ResultCache::ResultCache(std::size_t _capacity, unsigned _shards) {
+    // Every shard keeps at least one entry, so a small cache has less shards
+    _capacity = _capacity ? _capacity : 1;
+    _shards = _shards ? _shards : 1;
+    if (_shards > _capacity)
+        _shards = static_cast<unsigned>(_capacity);
+    m_capacity = _capacity;
+    // The first shards keep the entries left by the division
+    for (auto i(0u); i < _shards; i++) {
+        std::size_t _slots = _capacity / _shards + (i < _capacity % _shards);
+        m_shards.emplace_back(new Shard);
+        m_shards.back()->slots.resize(_slots);
+        m_shards.back()->index.reserve(_slots);
+    }
+}
+
+// Find
+bool ResultCache::find(std::string_view _expr, Result &_return) {
+    auto _hash = hash(_expr);
+    auto &_shard = shard(_hash);
+    {
+        std::lock_guard<std::mutex> _lock(_shard.mutex);
+        auto _it = _shard.index.find(_hash);
+        if (_it != _shard.index.end()) {
+            auto &_slot = _shard.slots[_it->second];
+            if (_slot.expr == _expr) {
+                _slot.referenced = true;
+                _return = _slot.result;
+                m_hits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// Insert
+void ResultCache::insert(std::string_view _expr, const Result &_result) {
+    auto _hash = hash(_expr);
+    auto &_shard = shard(_hash);
+    std::lock_guard<std::mutex> _lock(_shard.mutex);
+
+    unsigned _victim;
+    auto _it = _shard.index.find(_hash);
+    if (_it != _shard.index.end()) {
+        // Same hash: replace the entry (the text may differ on a collision)
+        _victim = _it->second;
+    } else {
+        // Give a second chance to the recently used entries
+        while (_shard.slots[_shard.hand].referenced) {
+            _shard.slots[_shard.hand].referenced = false;
+            _shard.hand = (_shard.hand + 1) % _shard.slots.size();
+        }
+        _victim = _shard.hand;
+        _shard.hand = (_shard.hand + 1) % _shard.slots.size();
+        if (_shard.slots[_victim].used)
+            _shard.index.erase(_shard.slots[_victim].hash);
+        _shard.index[_hash] = _victim;
+    }
+
+    auto &_slot = _shard.slots[_victim];
+    _slot.hash = _hash;
+    _slot.expr.assign(_expr.data(), _expr.size());
+    _slot.result = _result;
+    _slot.used = true;
+    _slot.referenced = false;
+}
+
+// Capacity
+std::size_t ResultCache::capacity() const {
+    return m_capacity;
+}
+
+// Hits
+std::size_t ResultCache::hits() const {
+    return m_hits.load(std::memory_order_relaxed);
+}
+
+// Misses
+std::size_t ResultCache::misses() const {
+    return m_misses.load(std::memory_order_relaxed);
+}
+
+// Hash (8 bytes at a time, with a final avalanche)
+std::uint64_t ResultCache::hash(std::string_view _expr) {
+    const std::uint64_t _mul = 0x9e3779b97f4a7c15ULL;
+    std::uint64_t _hash = _expr.size() * _mul;
+    std::size_t i = 0;
+    for (; i + 8 <= _expr.size(); i += 8) {
+        std::uint64_t _word;
+        std::memcpy(&_word, _expr.data() + i, 8);
+        _hash = (_hash ^ _word) * _mul;
+        _hash ^= _hash >> 29;
+    }
+    if (i < _expr.size()) {
+        std::uint64_t _word = 0;
+        std::memcpy(&_word, _expr.data() + i, _expr.size() - i);
+        _hash = (_hash ^ _word) * _mul;
+    }
+    _hash ^= _hash >> 32;
+    _hash *= _mul;
+    return _hash ^ (_hash >> 29);
+}
+
+// Gets the shard
+ResultCache::Shard &ResultCache::shard(std::uint64_t _hash) {
+    // The low bits pick the index bucket, so the shard uses the high ones
+    return *m_shards[(_hash >> 48) % m_shards.size()];
+}
@@ -0,0 +1,383 @@
+/*!
+ *  @file server.cpp
+ *  @brief Server Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with Server Class implementations
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "output.hpp"
+#include "server.hpp"
+
+// Bytes read from a connection by wake up
+static const std::size_t READ_SIZE = 1 << 16;
+// Responses waiting to be sent before a connection stops being read
+static const std::size_t MAX_PENDING = 1 << 20;
+// Events taken by wake up
+static const int MAX_EVENTS = 256;
+
+// Constructor
+Server::Server(ResultCache *_cache, bool _share)
+    : m_cache(_cache), m_share(_share) {
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event _event = {};
+    _event.events = EPOLLIN;
+    _event.data.fd = m_wakeup;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup, &_event);
+}
+
+// Destructor
+Server::~Server() {
+    for (auto &_connection : m_connections)
+        close(_connection.first);
+    for (auto _fd : m_listeners)
+        close(_fd);
+    if (!m_path.empty())
+        unlink(m_path.c_str());
+    close(m_wakeup);
+    close(m_epoll);
+}
+
+// Listen on a Unix domain socket
+bool Server::listen_unix(const std::string &_path) {
+    sockaddr_un _address = {};
+    if (_path.empty() || _path.size() >= sizeof(_address.sun_path))
+        return false;
+    _address.sun_family = AF_UNIX;
+    std::memcpy(_address.sun_path, _path.c_str(), _path.size() + 1);
+
+    // Replace a socket left by an old server (but nothing else)
+    struct stat _stat;
+    if (lstat(_path.c_str(), &_stat) == 0 && S_ISSOCK(_stat.st_mode))
+        unlink(_path.c_str());
+
+    int _fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_fd < 0)
+        return false;
+    if (bind(_fd, reinterpret_cast<sockaddr *>(&_address),
+             sizeof(_address)) != 0) {
+        close(_fd);
+        return false;
+    }
+    m_path = _path;
+    return listen(_fd);
+}
+
+// Listen on a TCP port
+bool Server::listen_tcp(unsigned short _port) {
+    sockaddr_in _address = {};
+    _address.sin_family = AF_INET;
+    _address.sin_port = htons(_port);
+    _address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int _fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_fd < 0)
+        return false;
+    int _on = 1;
+    setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &_on, sizeof(_on));
+    if (bind(_fd, reinterpret_cast<sockaddr *>(&_address),
+             sizeof(_address)) != 0) {
+        close(_fd);
+        return false;
+    }
+    return listen(_fd);
+}
+
+// Run
+bool Server::run() {
+    epoll_event _events[MAX_EVENTS];
+    bool _stop = false;
+
+    while (!_stop) {
+        int _ready = epoll_wait(m_epoll, _events, MAX_EVENTS, -1);
+        if (_ready < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        // Take the lines of all connections ready
+        for (auto i(0); i < _ready; i++) {
+            int _fd = _events[i].data.fd;
+            if (_fd == m_wakeup) {
+                _stop = true;
+                continue;
+            }
+            if (std::find(m_listeners.begin(), m_listeners.end(), _fd) !=
+                m_listeners.end()) {
+                accept(_fd);
+                continue;
+            }
+            auto _it = m_connections.find(_fd);
+            if (_it == m_connections.end())
+                continue;
+            Connection &_c = *_it->second;
+            if (!_c.touched) {
+                _c.touched = true;
+                m_touched.push_back(&_c);
+            }
+            if (_c.reading && (_events[i].events & (EPOLLIN | EPOLLHUP |
+                                                    EPOLLERR)))
+                receive(_c);
+        }
+
+        // Evaluate them together and send the responses
+        if (!m_batch.empty())
+            evaluate();
+        for (auto _c : m_touched)
+            send(*_c);
+
+        if (!m_batch.empty()) {
+            // Each request since its line was read, so the time waiting for
+            // the other reads of the batch counts too
+            auto _end = std::chrono::steady_clock::now();
+            for (const auto &_arrival : m_arrivals)
+                m_latency.add(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        _end - _arrival).count(),
+                    1);
+            m_requests += m_batch.size();
+            m_batches++;
+        }
+
+        // The lines taken aren't needed anymore
+        for (auto _c : m_touched) {
+            _c->input.erase(0, _c->parsed);
+            _c->parsed = 0;
+            _c->touched = false;
+            update(*_c);
+        }
+        m_batch.clear();
+        m_owners.clear();
+        m_arrivals.clear();
+        m_touched.clear();
+    }
+    return true;
+}
+
+// Stop
+void Server::stop() {
+    std::uint64_t _one = 1;
+    ssize_t _written = write(m_wakeup, &_one, sizeof(_one));
+    (void)_written;
+}
+
+// Report
+void Server::report(std::ostream &_os) const {
+    double _by_batch = m_batches > 0 ?
+        static_cast<double>(m_requests) / m_batches : 0;
+    _os << "Connections: " << m_accepted << "\n"
+        << "Requests: " << m_requests << "\n"
+        << "Batches: " << m_batches << " (" << _by_batch
+        << " requests by batch)\n"
+        << "Latency: p50 " << m_latency.percentile(0.5) / 1e3 << " us, p99 "
+        << m_latency.percentile(0.99) / 1e3 << " us, p99.9 "
+        << m_latency.percentile(0.999) / 1e3 << " us\n";
+}
+
+// Count a latency
+void Server::Histogram::add(std::uint64_t _ns, std::uint64_t _n) {
+    unsigned _bucket = _ns;
+    if (_ns >= 16) {
+        // The power of 2 and the 4 bits below it
+        unsigned _log = 63 - __builtin_clzll(_ns);
+        _bucket = (_log - 3) * 16 + ((_ns >> (_log - 4)) & 15);
+    }
+    counts[_bucket] += _n;
+    total += _n;
+}
+
+// Get a percentile
+std::uint64_t Server::Histogram::percentile(double _p) const {
+    auto _rank = std::max<std::uint64_t>(1, std::ceil(_p * total));
+    std::uint64_t _seen = 0;
+    for (auto b(0u); b < BUCKETS; b++) {
+        _seen += counts[b];
+        if (_seen < _rank)
+            continue;
+        if (b < 16)
+            return b;
+        return static_cast<std::uint64_t>(16 + b % 16) << (b / 16 - 1);
+    }
+    return 0;
+}
+
+// Add a listening socket
+bool Server::listen(int _fd) {
+    epoll_event _event = {};
+    _event.events = EPOLLIN;
+    _event.data.fd = _fd;
+    if (::listen(_fd, SOMAXCONN) != 0 ||
+        epoll_ctl(m_epoll, EPOLL_CTL_ADD, _fd, &_event) != 0) {
+        close(_fd);
+        return false;
+    }
+    m_listeners.push_back(_fd);
+    return true;
+}
+
+// Accept the pending connections
+void Server::accept(int _fd) {
+    while (true) {
+        int _client = accept4(_fd, nullptr, nullptr,
+                              SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (_client < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        // The responses of TCP clients aren't delayed (it fails on Unix
+        // sockets, which don't delay them anyway)
+        int _on = 1;
+        setsockopt(_client, IPPROTO_TCP, TCP_NODELAY, &_on, sizeof(_on));
+
+        epoll_event _event = {};
+        _event.events = EPOLLIN;
+        _event.data.fd = _client;
+        if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, _client, &_event) != 0) {
+            close(_client);
+            continue;
+        }
+        std::unique_ptr<Connection> _c(new Connection);
+        _c->fd = _client;
+        m_connections[_client] = std::move(_c);
+        m_accepted++;
+    }
+}
+
+// Receive lines
+void Server::receive(Connection &_c) {
+    char _buffer[READ_SIZE];
+    ssize_t _read;
+    do {
+        _read = recv(_c.fd, _buffer, READ_SIZE, 0);
+    } while (_read < 0 && errno == EINTR);
+    auto _now = std::chrono::steady_clock::now();
+    if (_read > 0)
+        _c.input.append(_buffer, _read);
+    else if (_read == 0)
+        _c.eof = true;
+    else if (_read < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        _c.failed = true;
+
+    // Take the whole lines (and the last one, without a line break, at the
+    // end of the connection)
+    const char *_data = _c.input.data();
+    const char *_begin = _data + _c.parsed;
+    const char *_end = _data + _c.input.size();
+    while (const void *_nl = std::memchr(_begin, '\n', _end - _begin)) {
+        auto _stop = static_cast<const char *>(_nl);
+        m_batch.emplace_back(_begin, _stop - _begin);
+        m_owners.push_back(&_c);
+        m_arrivals.push_back(_now);
+        _begin = _stop + 1;
+    }
+    if (_c.eof && _begin < _end) {
+        m_batch.emplace_back(_begin, _end - _begin);
+        m_owners.push_back(&_c);
+        m_arrivals.push_back(_now);
+        _begin = _end;
+    }
+    _c.parsed = _begin - _data;
+}
+
+// Send responses
+void Server::send(Connection &_c) {
+    while (!_c.failed && _c.sent < _c.output.size()) {
+        ssize_t _written = ::send(_c.fd, _c.output.data() + _c.sent,
+                                  _c.output.size() - _c.sent, MSG_NOSIGNAL);
+        if (_written > 0)
+            _c.sent += _written;
+        else if (_written < 0 && errno == EINTR)
+            continue;
+        else if (_written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        else
+            _c.failed = true;
+    }
+    if (_c.sent == _c.output.size()) {
+        _c.output.clear();
+        _c.sent = 0;
+    } else if (_c.sent >= READ_SIZE) {
+        _c.output.erase(0, _c.sent);
+        _c.sent = 0;
+    }
+}
+
+// Evaluate the batch
+void Server::evaluate() {
+    m_results.resize(m_batch.size());
+    if (m_share) {
+        // Only the lines not cached are evaluated, all together
+        m_misses.clear();
+        m_positions.clear();
+        for (auto i(0u); i < m_batch.size(); i++) {
+            if (m_cache != nullptr && m_cache->find(m_batch[i], m_results[i]))
+                continue;
+            m_misses.push_back(m_batch[i]);
+            m_positions.push_back(i);
+        }
+        Expression::calculate_batch(m_misses, m_miss_results);
+        for (auto i(0u); i < m_positions.size(); i++) {
+            m_results[m_positions[i]] = m_miss_results[i];
+            if (m_cache != nullptr)
+                m_cache->insert(m_misses[i], m_miss_results[i]);
+        }
+    } else {
+        for (auto i(0u); i < m_batch.size(); i++) {
+            if (m_cache != nullptr && m_cache->find(m_batch[i], m_results[i]))
+                continue;
+            m_expr.reset(m_batch[i]);
+            m_expr.calculate(m_results[i]);
+            if (m_cache != nullptr)
+                m_cache->insert(m_batch[i], m_results[i]);
+        }
+    }
+
+    char _line[Output::MAX_LINE];
+    for (auto i(0u); i < m_batch.size(); i++)
+        m_owners[i]->output.append(_line, Output::format(m_results[i], _line));
+}
+
+// Update a connection
+bool Server::update(Connection &_c) {
+    bool _writing = _c.sent < _c.output.size();
+    if (_c.failed || (_c.eof && !_writing)) {
+        int _fd = _c.fd;
+        epoll_ctl(m_epoll, EPOLL_CTL_DEL, _fd, nullptr);
+        close(_fd);
+        m_connections.erase(_fd);
+        return false;
+    }
+
+    // Don't read a client that doesn't read its responses
+    bool _reading = !_c.eof && _c.output.size() - _c.sent < MAX_PENDING;
+    if (_reading != _c.reading || _writing != _c.writing) {
+        epoll_event _event = {};
+        _event.events = (_reading ? EPOLLIN : 0) | (_writing ? EPOLLOUT : 0);
+        _event.data.fd = _c.fd;
+        epoll_ctl(m_epoll, EPOLL_CTL_MOD, _c.fd, &_event);
+        _c.reading = _reading;
+        _c.writing = _writing;
+    }
+    return true;
+}
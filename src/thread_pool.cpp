@@ -0,0 +1,90 @@
+/*!
+ *  @file thread_pool.cpp
+ *  @brief ThreadPool Implementations
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with ThreadPool Class implementations
+ */
+
+#include <mutex>
+#include <thread>
+
+#include "thread_pool.hpp"
+
+// Constructor
+ThreadPool::ThreadPool(unsigned _threads) {
+    _threads = _threads ? _threads : 1;
+    for (auto i(0u); i < _threads; i++)
+        m_workers.emplace_back(new Worker);
+    for (auto i(0u); i < _threads; i++)
+        m_threads.emplace_back(&ThreadPool::work, this, i);
+}
+
+// Destructor
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> _lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeup.notify_all();
+    for (auto &_thread : m_threads)
+        _thread.join();
+}
+
+// Submit
+void ThreadPool::submit(Task _task) {
+    auto &_worker = *m_workers[m_next++ % m_workers.size()];
+    {
+        std::lock_guard<std::mutex> _lock(_worker.mutex);
+        _worker.tasks.push_back(std::move(_task));
+    }
+    {
+        std::lock_guard<std::mutex> _lock(m_mutex);
+        m_pending++;
+    }
+    m_wakeup.notify_one();
+}
+
+// Size
+unsigned ThreadPool::size() const {
+    return m_workers.size();
+}
+
+// Take a task
+bool ThreadPool::take(unsigned _worker, Task &_return) {
+    // Try the own deque first (oldest task), then steal (newest task, so
+    // the owner keeps the ones it would run next)
+    for (auto i(0u); i < m_workers.size(); i++) {
+        auto &_victim = *m_workers[(_worker + i) % m_workers.size()];
+        std::lock_guard<std::mutex> _lock(_victim.mutex);
+        if (_victim.tasks.empty())
+            continue;
+        if (i == 0) {
+            _return = std::move(_victim.tasks.front());
+            _victim.tasks.pop_front();
+        } else {
+            _return = std::move(_victim.tasks.back());
+            _victim.tasks.pop_back();
+        }
+        return true;
+    }
+    return false;
+}
+
+// Worker loop
+void ThreadPool::work(unsigned _worker) {
+    Task _task;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> _lock(m_mutex);
+            m_wakeup.wait(_lock, [this] { return m_stop || m_pending > 0; });
+            if (m_pending == 0)
+                return;
+            m_pending--;
+        }
+        // A pending task is reserved, so it's on some deque
+        while (!take(_worker, _task))
+            std::this_thread::yield();
+        _task(_worker);
+    }
+}
@@ -0,0 +1,130 @@
+/*!
+ *  @file bares.cpp
+ *  @brief Compile Time Evaluation Test
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the test of bares::eval and bares::calculate: the constant
+ *  cases are checked by the compiler (this file doesn't compile if one
+ *  fails), the others at run time, against the Expression
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "bares.hpp"
+#include "expression.hpp"
+
+//! @name Values
+//! @{
+static_assert(bares::eval("3 * 2") == 6);
+static_assert(bares::eval("1 + 2 * 3") == 7);
+static_assert(bares::eval("(1 + 2) * 3") == 9);
+static_assert(bares::eval("2 ^ 3 ^ 2") == 64);
+static_assert(bares::eval("-(2 ^ 3) % 5") == -3);
+static_assert(bares::eval("- -4") == -4);
+static_assert(bares::eval("100 / 7 - 3 * (2 - 9)") == 35);
+static_assert(bares::eval("2 ^ -1") == 0);
+static_assert(bares::eval("  007 ") == 7);
+static_assert(bares::eval("32767") == 32767);
+static_assert(bares::eval<Int32>("32767 + 1") == 32768);
+static_assert(bares::eval<Int64>("2 ^ 40") == 1099511627776);
+//! @}
+
+//! @name Errors (ids and columns from 0, as on the Result)
+//! @{
+static_assert(bares::calculate("40000").error == 0);
+static_assert(bares::calculate("1 + 40000").col == 4);
+static_assert(bares::calculate("2 +").error == 1);
+static_assert(bares::calculate("2 +").col == 3);
+static_assert(bares::calculate("4 $ 2").error == 2);
+static_assert(bares::calculate("4 $ 2").col == 2);
+static_assert(bares::calculate("2 3").error == 3);
+static_assert(bares::calculate("2 3").col == 2);
+static_assert(bares::calculate(")").error == 4);
+static_assert(bares::calculate("(1))").col == 3);
+static_assert(bares::calculate("(1)(2)").error == 3);
+static_assert(bares::calculate("(1)(2)").col == 3);
+static_assert(bares::calculate("1 + * 2").error == 5);
+static_assert(bares::calculate("1 + * 2").col == 4);
+static_assert(bares::calculate("(3").error == 6);
+static_assert(bares::calculate("(3").col == 0);
+static_assert(bares::calculate("10 / (5 - 5)").error == 7);
+static_assert(bares::calculate("10 / (5 - 5)").col == -1);
+static_assert(bares::calculate("32767 + 1").error == 8);
+// A syntax error found later on the line takes precedence
+static_assert(bares::calculate("1 / 0 + )").error == 4);
+static_assert(bares::calculate("").empty);
+//! @}
+
+//! The number of failures
+static unsigned failures = 0;
+
+/**
+ * @brief Verify the message of an invalid expression
+ * @param _expr The expression
+ * @param _message The expected message
+ */
+static void expect_invalid(std::string_view _expr,
+                           const std::string &_message) {
+    try {
+        bares::eval(_expr);
+    } catch (const std::invalid_argument &_e) {
+        if (_e.what() == _message)
+            return;
+        std::cerr << "\"" << _expr << "\": got \"" << _e.what()
+                  << "\", expected \"" << _message << "\"" << std::endl;
+        failures++;
+        return;
+    }
+    std::cerr << "\"" << _expr << "\": not rejected" << std::endl;
+    failures++;
+}
+
+/**
+ * @brief Compare bares::calculate with the Expression on random lines
+ * @param _lines The number of lines
+ */
+static void test_random(unsigned _lines) {
+    const char ALPHABET[] = "0123456789+-*/%^()  1a";
+    std::mt19937 _random(2016);
+    Expression _expr{std::string_view()};
+    for (unsigned i = 0; i < _lines; i++) {
+        std::string _line;
+        for (auto n = _random() % 24; n > 0; n--)
+            _line += ALPHABET[_random() % (sizeof(ALPHABET) - 1)];
+        Result _expected;
+        _expr.reset(_line);
+        _expr.calculate(_expected);
+        auto _result = bares::calculate(_line);
+        if (_result.value == _expected.value &&
+            _result.error == _expected.error &&
+            _result.col == _expected.col && _result.empty == _expected.empty)
+            continue;
+        if (failures++ < 10)
+            std::cerr << "\"" << _line << "\": got value " << _result.value
+                      << " error " << _result.error << " col " << _result.col
+                      << ", expected value " << _expected.value << " error "
+                      << _expected.error << " col " << _expected.col
+                      << std::endl;
+    }
+}
+
+// Main Function
+int main() {
+    // Out of a constant expression, the errors are thrown (columns from 1)
+    expect_invalid("4 $ 2", "E3 at column 3");
+    expect_invalid("2 +", "E2 at column 4");
+    expect_invalid("(3", "E7 at column 1");
+    expect_invalid("10 / (5 - 5)", "E8");
+    expect_invalid("32767 + 1", "E9");
+    test_random(100000);
+    if (failures != 0) {
+        std::cerr << failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+/*!
+ *  @file editable_expression.cpp
+ *  @brief Editable Expression Test
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the differential test of the Editable Expression: after each
+ *  edit (random, on random texts), its Result must be the same of an
+ *  Expression evaluating the whole text again
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "editable_expression.hpp"
+#include "expression.hpp"
+
+//! The characters of the random texts (with invalid ones, for the errors)
+static const char ALPHABET[] = "0123456789+-*/%^()  ()+1a$";
+
+//! The number of failures
+static unsigned failures = 0;
+
+/**
+ * @brief Generate a random string
+ * @param _random The random numbers generator
+ * @param _size The number of characters
+ * @return The string
+ */
+static std::string random_text(std::mt19937 &_random, std::size_t _size) {
+    std::string _return;
+    for (std::size_t i = 0; i < _size; i++)
+        _return += ALPHABET[_random() % (sizeof(ALPHABET) - 1)];
+    return _return;
+}
+
+/**
+ * @brief Compare an Editable Expression with the whole text evaluated again
+ * @param _editable The Editable Expression
+ * @param _text The expected text
+ */
+static void check(EditableExpression &_editable, const std::string &_text) {
+    Result _expected, _result;
+    Expression _expr{std::string_view(_text)};
+    bool _ok = _expr.calculate(_expected);
+    if (_editable.text() == _text && _editable.calculate(_result) == _ok &&
+        _result.value == _expected.value &&
+        _result.error == _expected.error && _result.col == _expected.col &&
+        _result.empty == _expected.empty && _result.zeros == _expected.zeros)
+        return;
+    if (failures++ < 10)
+        std::cerr << "\"" << _text << "\": got \"" << _editable.text()
+                  << "\" value " << _result.value << " error "
+                  << _result.error << " col " << _result.col
+                  << ", expected value " << _expected.value << " error "
+                  << _expected.error << " col " << _expected.col
+                  << std::endl;
+}
+
+/**
+ * @brief Edit random texts at random, checking after the edits
+ * @param _random The random numbers generator
+ * @param _texts The number of texts
+ * @param _size The maximum text size
+ * @param _edits The number of edits by text
+ */
+static void test_edits(std::mt19937 &_random, unsigned _texts,
+                       std::size_t _size, unsigned _edits) {
+    for (unsigned t = 0; t < _texts; t++) {
+        std::string _text = random_text(_random, _random() % (_size + 1));
+        EditableExpression _editable(_text);
+        check(_editable, _text);
+        for (unsigned e = 0; e < _edits; e++) {
+            std::size_t _offset = _random() % (_text.size() + 1);
+            std::size_t _removed = std::min<std::size_t>(
+                _random() % 4, _text.size() - _offset);
+            std::string _inserted = random_text(_random, _random() % 4);
+            _text.replace(_offset, _removed, _inserted);
+            if (!_editable.edit(_offset, _removed, _inserted) &&
+                failures++ < 10)
+                std::cerr << "edit refused on \"" << _text << "\""
+                          << std::endl;
+            // Also a few edits before each calculate
+            if (_random() % 3 == 0)
+                check(_editable, _text);
+        }
+        check(_editable, _text);
+    }
+}
+
+/**
+ * @brief Edit out of the text range, which must change nothing
+ */
+static void test_out_of_range() {
+    const std::size_t MAX = std::numeric_limits<std::size_t>::max();
+    std::string _text = "(1 + 2) * 3";
+    EditableExpression _editable(_text);
+    check(_editable, _text);
+
+    const std::size_t _size = _text.size();
+    const std::size_t EDITS[][2] = {
+        {_size + 1, 0}, {_size, 1}, {0, _size + 1},
+        {_size - 2, 3}, {MAX, 0},   {1, MAX},
+    };
+    for (const auto &_edit : EDITS) {
+        if (_editable.edit(_edit[0], _edit[1], "7") && failures++ < 10)
+            std::cerr << "edit(" << _edit[0] << ", " << _edit[1]
+                      << ") accepted on \"" << _text << "\"" << std::endl;
+        check(_editable, _text);
+    }
+
+    // The whole range is still editable, up to the end
+    if (!_editable.edit(_size, 0, " + 1") || !_editable.edit(0, _size + 4, ""))
+        failures++;
+    check(_editable, "");
+    if (!_editable.edit(0, 0, "007"))
+        failures++;
+    check(_editable, "007");
+}
+
+// Main Function
+int main() {
+    std::mt19937 _random(2016);
+    test_edits(_random, 20000, 20, 30);
+    test_edits(_random, 20, 2000, 300);
+    test_out_of_range();
+    if (failures != 0) {
+        std::cerr << failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
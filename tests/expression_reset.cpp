@@ -0,0 +1,182 @@
+/*!
+ *  @file expression_reset.cpp
+ *  @brief Expression Reset Test
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the test of an Expression reused across lines (see
+ *  Expression::reset), where each line must not see the state left by the
+ *  previous one (e.g. the stacks of a line that failed midway), and of
+ *  lines with variables
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "expression.hpp"
+#include "program.hpp"
+
+/**
+ * @brief A line and its expected Result
+ */
+struct Case {
+    std::string_view line;  //!< The expression
+    int value;              //!< The value (0 on errors)
+    int error;              //!< The error id (-1 if there is no error)
+    int col;                //!< The error column (-1 if it has no column)
+    bool empty;             //!< True if the line has no terms
+    int zeros;              //!< The value leading zeros
+};
+
+//! Error and valid lines alternated, so each line follows a different state
+static const Case CASES[] = {
+    {"2 +", 0, 1, 3, false, 0},
+    {"1+2", 3, -1, -1, false, 0},
+    {"(3", 0, 6, 0, false, 0},
+    {"  7 * 6", 42, -1, -1, false, 0},
+    {"10 / (5-5)", 0, 7, -1, false, 0},
+    {"5 % 3", 2, -1, -1, false, 0},
+    {"32767 + 1", 0, 8, -1, false, 0},
+    {"-(2^3)", -8, -1, -1, false, 0},
+    {"4 $ 2", 0, 2, 2, false, 0},
+    {"", 0, -1, -1, true, 0},
+    {"40000", 0, 0, 0, false, 0},
+    {"007", 7, -1, -1, false, 2},
+    {")", 0, 4, 0, false, 0},
+    {" ( 1 )", 1, -1, -1, false, 0},
+    {"2 3", 0, 3, 2, false, 0},
+    {"(1 + 2) * 3", 9, -1, -1, false, 0},
+    {"2 * (3 + )", 0, 1, 9, false, 0},
+    {"a", 0, 2, 0, false, 0},
+    {"2 ^ 3 ^ 2", 64, -1, -1, false, 0},
+};
+
+//! The variables of VARIABLE_CASES and their values
+static const std::vector<std::string> VARIABLES = {"x", "y_1"};
+static const int VALUES[] = {7, -3};
+
+//! Lines with variables, compiled with VARIABLES (a byte out of ASCII next
+//! to a name isn't part of it, and mustn't be taken as a letter)
+static const Case VARIABLE_CASES[] = {
+    {"x + 1", 8, -1, -1, false, 0},
+    {"z + 1", 0, 2, 0, false, 0},
+    {"(x - y_1) ^ 2", 100, -1, -1, false, 0},
+    {"x + y", 0, 1, 4, false, 0},
+    {"x * y_1", -21, -1, -1, false, 0},
+    {"y_1y", 0, 2, 0, false, 0},
+    {"x / (y_1 + 3)", 0, 7, -1, false, 0},
+    {"x\xC3\xA9 + 1", 0, 2, 1, false, 0},
+    {"\xFFx + 1", 0, 2, 0, false, 0},
+    {"x + \x80", 0, 1, 4, false, 0},
+};
+
+/**
+ * @brief Compare a Result with the expected one
+ * @param _path The evaluation path (for the failure message)
+ * @param _case The line and its expected Result
+ * @param _result The Result
+ *
+ * @return True if they are equal, False if not (and prints the difference)
+ */
+static bool check(const char *_path, const Case &_case,
+                  const Result &_result) {
+    if (_result.value == _case.value && _result.error == _case.error &&
+        _result.col == _case.col && _result.empty == _case.empty &&
+        _result.zeros == _case.zeros)
+        return true;
+    std::cerr << _path << " \"" << _case.line << "\": got value "
+              << _result.value << " error " << _result.error << " col "
+              << _result.col << " empty " << _result.empty << " zeros "
+              << _result.zeros << ", expected value " << _case.value
+              << " error " << _case.error << " col " << _case.col
+              << " empty " << _case.empty << " zeros " << _case.zeros
+              << std::endl;
+    return false;
+}
+
+/**
+ * @brief Calculate all lines with one Expression
+ * @param _mode The evaluation mode
+ * @param _path The mode name (for the failure messages)
+ *
+ * @return The number of failures
+ */
+static unsigned test_calculate(Expression::Mode _mode, const char *_path) {
+    unsigned _failures = 0;
+    Expression _expr{std::string_view()};
+    // Twice, so the first line also follows the state of the last one
+    for (auto i = 0; i < 2; i++) {
+        for (const auto &_case : CASES) {
+            Result _result;
+            _expr.reset(_case.line);
+            bool _ok = _expr.calculate(_result, _mode);
+            if (!check(_path, _case, _result) || _ok != !_result.is_error())
+                _failures++;
+        }
+    }
+    return _failures;
+}
+
+/**
+ * @brief Compile all lines with one Expression to one Program
+ * @return The number of failures
+ */
+static unsigned test_compile() {
+    unsigned _failures = 0;
+    Expression _expr{std::string_view()};
+    Program _program;
+    for (auto i = 0; i < 2; i++) {
+        for (const auto &_case : CASES) {
+            Result _result;
+            _expr.reset(_case.line);
+            _expr.compile(_program);
+            bool _ok = _program.eval(_result);
+            if (!check("compile", _case, _result) ||
+                _ok != !_result.is_error())
+                _failures++;
+        }
+    }
+    return _failures;
+}
+
+/**
+ * @brief Compile the lines with variables with one Expression and evaluate
+ * them with VALUES
+ * @return The number of failures
+ */
+static unsigned test_variables() {
+    unsigned _failures = 0;
+    Expression _expr{std::string_view()};
+    Program _program;
+    for (auto i = 0; i < 2; i++) {
+        for (const auto &_case : VARIABLE_CASES) {
+            Result _result;
+            _expr.reset(_case.line);
+            _expr.compile(_program, VARIABLES);
+            bool _ok = _program.eval(VALUES, _result.value, _result.error);
+            // A compilation error has a column, an operation error hasn't
+            if (!_program.is_valid()) {
+                _result.error = _program.error_id();
+                _result.col = _program.error_col();
+            }
+            if (!check("variables", _case, _result) ||
+                _ok != !_result.is_error())
+                _failures++;
+        }
+    }
+    return _failures;
+}
+
+// Main Function
+int main() {
+    unsigned _failures = test_calculate(Expression::FUSED, "fused") +
+                         test_calculate(Expression::PHASED, "phased") +
+                         test_compile() + test_variables();
+    if (_failures != 0) {
+        std::cerr << _failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+/*!
+ *  @file pipeline.cpp
+ *  @brief Pipeline Test
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the test of the Pipeline: the results of a stream, and a read
+ *  failure reported as a failed run (not as the end of the input)
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "pipeline.hpp"
+
+//! The number of failures
+static unsigned failures = 0;
+
+/**
+ * @brief Count a failure when a condition is false
+ * @param _condition The condition
+ * @param _what The condition description (for the failure message)
+ */
+static void expect(bool _condition, const std::string &_what) {
+    if (_condition)
+        return;
+    std::cerr << "failed: " << _what << std::endl;
+    failures++;
+}
+
+// Main Function
+int main() {
+    const std::string _path = "/tmp/bares_test_" + std::to_string(getpid());
+
+    // The lines of a pipe (the last one without a line break)
+    int _in[2];
+    expect(pipe(_in) == 0, "open a pipe");
+    const std::string _lines = "1 + 2\n2 +\n\n007\n10 / 0";
+    expect(write(_in[1], _lines.data(), _lines.size()) ==
+               static_cast<ssize_t>(_lines.size()),
+           "write the lines");
+    close(_in[1]);
+    int _out = open(_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    Pipeline _pipeline;
+    expect(_pipeline.run(_in[0], _out) && !_pipeline.read_failed(),
+           "run on a pipe");
+    close(_in[0]);
+    close(_out);
+
+    std::string _results(256, '\0');
+    int _file = open(_path.c_str(), O_RDONLY);
+    _results.resize(read(_file, &_results[0], _results.size()));
+    close(_file);
+    expect(_results == "3\nE2 4\n\n007\nE8\n", "the results: " + _results);
+
+    // A directory can be opened, but not read
+    int _dir = open("/", O_RDONLY);
+    _out = open("/dev/null", O_WRONLY);
+    expect(!_pipeline.run(_dir, _out) && _pipeline.read_failed(),
+           "a failed read");
+    close(_dir);
+    close(_out);
+
+    unlink(_path.c_str());
+    if (failures != 0) {
+        std::cerr << failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/*!
+ *  @file program_file.cpp
+ *  @brief Program File Test
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the test of the Program files: a compiled input loaded again
+ *  gives the Results of its Expressions, the same input always gives the
+ *  same file, and a damaged file is rejected before evaluating anything
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+#include "expression.hpp"
+#include "input.hpp"
+#include "program_file.hpp"
+
+//! The compiled lines: values, errors of each kind, empty and padded
+static const char INPUT[] =
+    "1 + 2\n"
+    "2 +\n"
+    "\n"
+    "007\n"
+    "10 / (5 - 5)\n"
+    "(3\n"
+    "-(2 ^ 3) * 4 % 5\n"
+    "32767 + 1\n"
+    "40000\n"
+    "4 $ 2\n"
+    ")\n"
+    "2 3\n"
+    "  ( ( 1 ) )  \n"
+    "a\n"
+    "2 * (3 + )\n"
+    "100 / 7 - 3 * (2 - 9)";
+
+//! The number of failures
+static unsigned failures = 0;
+
+/**
+ * @brief Count a failure when a condition is false
+ * @param _condition The condition
+ * @param _what The condition description (for the failure message)
+ */
+static void expect(bool _condition, const std::string &_what) {
+    if (_condition)
+        return;
+    std::cerr << "failed: " << _what << std::endl;
+    failures++;
+}
+
+/**
+ * @brief Read a whole file
+ * @param _path The file path
+ * @return The file content
+ */
+static std::string read_file(const std::string &_path) {
+    std::ifstream _file(_path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(_file),
+                       std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Write a whole file
+ * @param _path The file path
+ * @param _content The file content
+ */
+static void write_file(const std::string &_path, const std::string &_content) {
+    std::ofstream _file(_path, std::ios::binary | std::ios::trunc);
+    _file.write(_content.data(), _content.size());
+}
+
+/**
+ * @brief Compile the test input
+ * @param _path The Program file path
+ * @return True if it was written, False if not
+ */
+static bool compile(const std::string &_path) {
+    Input _input(INPUT, sizeof(INPUT) - 1);
+    return ProgramFile::write(_path, _input);
+}
+
+/**
+ * @brief Load a damaged copy of a Program file
+ * @param _path The damaged file path
+ * @param _content The damaged content
+ * @return The load status
+ */
+static ProgramFile::Status load(const std::string &_path,
+                                const std::string &_content) {
+    write_file(_path, _content);
+    return ProgramFile(_path).status();
+}
+
+// Main Function
+int main() {
+    const std::string _base = "/tmp/bares_test_" + std::to_string(getpid());
+    const std::string _path = _base + ".prg";
+    const std::string _copy = _base + "_copy.prg";
+
+    expect(compile(_path), "compile the input");
+    {
+        // Every line gives the Result of its Expression
+        ProgramFile _file(_path);
+        expect(_file.status() == ProgramFile::OK, "load the compiled file");
+        Input _input(INPUT, sizeof(INPUT) - 1);
+        Expression _expr{std::string_view()};
+        std::string_view _line;
+        std::size_t i = 0;
+        for (; _input.next(_line) && i < _file.size(); i++) {
+            Result _expected, _loaded;
+            _expr.reset(_line);
+            bool _ok = _expr.calculate(_expected);
+            int _column = -1;
+            expect(_file.eval(i, _loaded, &_column) == _ok &&
+                       _loaded.value == _expected.value &&
+                       _loaded.error == _expected.error &&
+                       _loaded.col == _expected.col &&
+                       _loaded.empty == _expected.empty &&
+                       _loaded.zeros == _expected.zeros,
+                   "the Result of \"" + std::string(_line) + "\"");
+            // A syntax error keeps its column, an evaluation error the
+            // column of the operator that failed
+            if (_expected.col >= 0)
+                expect(_column == _expected.col,
+                       "the column of \"" + std::string(_line) + "\"");
+        }
+        expect(i == _file.size() && !_input.next(_line),
+               "one Program by line");
+    }
+    {
+        ProgramFile _file(_path);
+        Result _result;
+        int _column = -1;
+        _file.eval(4, _result, &_column);
+        expect(_result.error == 7 && _column == 3,
+               "the column of the division by zero");
+    }
+
+    // The same input always gives the same bytes, even the padding of each
+    // instruction (between its 1-byte opcode and its 4-byte value), which
+    // would keep whatever was on memory
+    const std::string _content = read_file(_path);
+    expect(compile(_copy) && read_file(_copy) == _content,
+           "the same file from the same input");
+    std::uint64_t _programs, _index;
+    std::memcpy(&_programs, &_content[16], sizeof(_programs));
+    std::memcpy(&_index, &_content[24], sizeof(_index));
+    for (std::uint64_t i = 0; i < _programs; i++) {
+        std::uint64_t _record;
+        std::uint32_t _size;
+        std::memcpy(&_record, &_content[_index + i * 8], sizeof(_record));
+        std::memcpy(&_size, &_content[_record + 12], sizeof(_size));
+        for (std::uint32_t j = 0; j < _size; j++) {
+            auto _instruction = &_content[_record + 24 + j * 8];
+            expect(_instruction[1] == 0 && _instruction[2] == 0 &&
+                       _instruction[3] == 0,
+                   "the padding of instruction " + std::to_string(j) +
+                       " of line " + std::to_string(i + 1));
+        }
+    }
+
+    // Damaged files
+    expect(ProgramFile(_base + "_missing.prg").status() ==
+               ProgramFile::CANNOT_OPEN,
+           "a missing file");
+    expect(load(_copy, _content.substr(0, 32)) == ProgramFile::BAD_FORMAT,
+           "a file truncated in the header");
+    expect(load(_copy, _content.substr(0, _content.size() - 8)) ==
+               ProgramFile::BAD_FORMAT,
+           "a file truncated in the index");
+    std::string _damaged = _content;
+    _damaged[0] = 'X';
+    expect(load(_copy, _damaged) == ProgramFile::BAD_FORMAT, "a bad magic");
+    _damaged = _content;
+    std::uint32_t _version = ProgramFile::VERSION + 1;
+    std::memcpy(&_damaged[8], &_version, sizeof(_version));
+    expect(load(_copy, _damaged) == ProgramFile::BAD_VERSION,
+           "another version");
+    _damaged = _content;
+    std::uint32_t _order = 0x04030201;
+    std::memcpy(&_damaged[12], &_order, sizeof(_order));
+    expect(load(_copy, _damaged) == ProgramFile::BAD_VERSION,
+           "another byte order");
+    _damaged = _content;
+    _damaged[_content.size() / 2] ^= 1;
+    expect(load(_copy, _damaged) == ProgramFile::BAD_CHECKSUM,
+           "a changed byte");
+    expect(load(_copy, _content) == ProgramFile::OK, "the restored file");
+
+    unlink(_path.c_str());
+    unlink(_copy.c_str());
+    if (failures != 0) {
+        std::cerr << failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
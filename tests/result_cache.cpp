@@ -0,0 +1,79 @@
+/*!
+ *  @file result_cache.cpp
+ *  @brief ResultCache Test
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the test of the ResultCache capacity: a cache keeps at most
+ *  the number of entries asked for, even when it's less than the shards
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "result.hpp"
+#include "result_cache.hpp"
+
+//! The number of failures
+static unsigned failures = 0;
+
+/**
+ * @brief Count a failure when a condition is false
+ * @param _condition The condition
+ * @param _what The condition description (for the failure message)
+ */
+static void expect(bool _condition, const std::string &_what) {
+    if (_condition)
+        return;
+    std::cerr << "failed: " << _what << std::endl;
+    failures++;
+}
+
+/**
+ * @brief Fill a cache with more expressions than it keeps
+ * @param _capacity The capacity asked for
+ * @param _shards The number of shards
+ */
+static void test_capacity(std::size_t _capacity, unsigned _shards) {
+    const auto _name = "capacity " + std::to_string(_capacity) + " on " +
+                       std::to_string(_shards) + " shards";
+    ResultCache _cache(_capacity, _shards);
+    expect(_cache.capacity() == _capacity, _name + ": reported");
+
+    const unsigned _inserted = 4 * _capacity + 8;
+    for (auto i(0u); i < _inserted; i++) {
+        Result _result;
+        _result.value = static_cast<int>(i);
+        _cache.insert(std::to_string(i) + " + 0", _result);
+    }
+    std::size_t _kept = 0;
+    for (auto i(0u); i < _inserted; i++) {
+        Result _result;
+        if (!_cache.find(std::to_string(i) + " + 0", _result))
+            continue;
+        expect(_result.value == static_cast<int>(i), _name + ": value");
+        _kept++;
+    }
+    expect(_kept <= _capacity, _name + ": kept " + std::to_string(_kept));
+    // The last one is on its shard at least
+    Result _last;
+    expect(_cache.find(std::to_string(_inserted - 1) + " + 0", _last),
+           _name + ": the last one");
+}
+
+// Main Function
+int main() {
+    for (std::size_t _capacity = 1; _capacity <= 40; _capacity++) {
+        test_capacity(_capacity, 16);
+        test_capacity(_capacity, 1);
+    }
+    test_capacity(1000, 16);
+    // No shards is one shard, and no capacity is one entry
+    expect(ResultCache(0).capacity() == 1, "capacity 0");
+    expect(ResultCache(10, 0).capacity() == 10, "0 shards");
+    if (failures != 0) {
+        std::cerr << failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,228 @@
+/*!
+ *  @file thread_pool.cpp
+ *  @brief ThreadPool Test
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the test of the ThreadPool order: each worker runs its own
+ *  tasks oldest first, and the Driver writes the results of many threads in
+ *  the order of the input lines, holding a bounded number of them
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "driver.hpp"
+#include "input.hpp"
+#include "output.hpp"
+#include "thread_pool.hpp"
+
+//! The number of failures
+static unsigned failures = 0;
+
+/**
+ * @brief Count a failure when a condition is false
+ * @param _condition The condition
+ * @param _what The condition description (for the failure message)
+ */
+static void expect(bool _condition, const std::string &_what) {
+    if (_condition)
+        return;
+    std::cerr << "failed: " << _what << std::endl;
+    failures++;
+}
+
+/**
+ * @brief Run the tasks of blocked workers, checking each runs its own
+ * tasks in the order they were submitted
+ * @param _threads The number of workers
+ */
+static void test_order(unsigned _threads) {
+    std::mutex _mutex;
+    std::condition_variable _changed;
+    unsigned _blocked = 0;
+    bool _open = false;
+    std::vector<std::pair<unsigned, unsigned>> _runs;  // Worker and task
+
+    {
+        ThreadPool _pool(_threads);
+        // One blocking task by worker (submitted round-robin, so each one is
+        // on its own deque and the others can't steal it while busy)
+        for (auto i(0u); i < _threads; i++)
+            _pool.submit([&](unsigned) {
+                std::unique_lock<std::mutex> _lock(_mutex);
+                _blocked++;
+                _changed.notify_all();
+                _changed.wait(_lock, [&] { return _open; });
+            });
+        {
+            std::unique_lock<std::mutex> _lock(_mutex);
+            _changed.wait(_lock, [&] { return _blocked == _threads; });
+        }
+        // The task i goes to the deque of the worker i % _threads
+        for (auto i(_threads); i < 64 * _threads; i++)
+            _pool.submit([&, i](unsigned _worker) {
+                std::lock_guard<std::mutex> _lock(_mutex);
+                _runs.emplace_back(_worker, i);
+            });
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _open = true;
+        }
+        _changed.notify_all();
+    }
+
+    expect(_runs.size() == 63 * _threads, "all tasks run");
+    // The own tasks of a worker run oldest first (the stolen ones are taken
+    // newest first, from the back of the other deques)
+    std::vector<unsigned> _last(_threads, 0);
+    for (const auto &_run : _runs) {
+        if (_run.second % _threads != _run.first)
+            continue;
+        expect(_run.second > _last[_run.first],
+               "worker " + std::to_string(_run.first) + " ran task " +
+                   std::to_string(_run.second) + " after task " +
+                   std::to_string(_last[_run.first]));
+        _last[_run.first] = _run.second;
+    }
+}
+
+/**
+ * @brief Evaluate lines on many threads, checking the results order
+ * @param _text The lines
+ * @param _expected The results of a single thread
+ * @param _threads The number of threads
+ * @param _share Flag to share subexpressions
+ * @param _path A temporary file path
+ */
+static void test_driver(const std::string &_text, const std::string &_expected,
+                        unsigned _threads, bool _share,
+                        const std::string &_path) {
+    {
+        Input _input(_text.data(), _text.size());
+        Output _output(_path);
+        expect(Driver(_threads, nullptr, _share).run(_input, _output),
+               "run on " + std::to_string(_threads) + " threads");
+    }
+    std::string _results(_expected.size() + 1, '\0');
+    int _file = open(_path.c_str(), O_RDONLY);
+    _results.resize(read(_file, &_results[0], _results.size()));
+    close(_file);
+    expect(_results == _expected, "the results order on " +
+                                      std::to_string(_threads) + " threads" +
+                                      (_share ? " (shared)" : ""));
+}
+
+/**
+ * @brief Evaluate a pipe on many threads, without reading the results for
+ * a while, checking the lines taken meanwhile are bounded
+ * @param _threads The number of threads
+ *
+ * The Driver keeps a bounded number of chunks in flight and writes them
+ * oldest first, so when the results aren't read it stops reading too.
+ */
+static void test_bounded(unsigned _threads) {
+    const unsigned LINES = 1 << 21;
+    int _in[2], _out[2];
+    expect(pipe(_in) == 0 && pipe(_out) == 0, "open the pipes");
+    std::atomic<unsigned> _sent{0};
+
+    // Send the lines in small writes, counting them (the pipe blocks the
+    // writes once the Driver stops reading)
+    std::thread _feeder([&] {
+        std::string _block;
+        for (auto i(0u); i < LINES; i++) {
+            _block += "(" + std::to_string(i % 30000) + " + 1) - 1\n";
+            if ((i + 1) % 64 != 0 && i + 1 < LINES)
+                continue;
+            if (write(_in[1], _block.data(), _block.size()) !=
+                static_cast<ssize_t>(_block.size()))
+                break;
+            _block.clear();
+            _sent = i + 1;
+        }
+        close(_in[1]);
+    });
+    bool _run = false;
+    std::thread _driver([&] {
+        {
+            Input _input(_in[0]);
+            Output _output(_out[1], 1 << 12);
+            _run = Driver(_threads).run(_input, _output);
+        }
+        // The descriptors given to an Output aren't closed by it
+        close(_out[1]);
+    });
+
+    // The chunks in flight, the pipes and the buffers hold far less than
+    // this, while the whole input is 8 times more
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    unsigned _taken = _sent;
+    expect(_taken < LINES / 8, "lines taken with the results not read: " +
+                                   std::to_string(_taken));
+
+    // Then all results come, in order
+    std::string _results;
+    char _buffer[1 << 16];
+    ssize_t _read;
+    while ((_read = read(_out[0], _buffer, sizeof(_buffer))) > 0)
+        _results.append(_buffer, _read);
+    _feeder.join();
+    _driver.join();
+    close(_in[0]);
+    close(_out[0]);
+    expect(_run, "run on a pipe");
+    std::size_t _pos = 0;
+    bool _ordered = true;
+    for (auto i(0u); i < LINES && _ordered; i++) {
+        std::string _value = std::to_string(i % 30000) + "\n";
+        _ordered = _results.compare(_pos, _value.size(), _value) == 0;
+        _pos += _value.size();
+    }
+    expect(_ordered && _pos == _results.size(), "the results of a pipe");
+}
+
+// Main Function
+int main() {
+    test_order(1);
+    test_order(2);
+    test_order(4);
+
+    // More lines than the chunks kept in flight, each line a different
+    // result (and some errors), so a line out of order shows
+    const std::string _path = "/tmp/bares_test_" + std::to_string(getpid());
+    std::string _text, _expected;
+    for (auto i(0u); i < 300000; i++) {
+        std::string _value = std::to_string(i % 30000);
+        if (i % 1001 == 0) {
+            _text += _value + " / 0\n";
+            _expected += "E8\n";
+        } else {
+            _text += "(" + _value + " + 1) - 1\n";
+            _expected += _value + "\n";
+        }
+    }
+    for (auto _threads : {2u, 3u, 8u}) {
+        test_driver(_text, _expected, _threads, false, _path);
+        test_driver(_text, _expected, _threads, true, _path);
+    }
+    test_bounded(2);
+    test_bounded(4);
+
+    unlink(_path.c_str());
+    if (failures != 0) {
+        std::cerr << failures << " failures" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,339 @@
+/*!
+ *  @file generate.cpp
+ *  @brief Workload Generator File
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the synthetic workload generator main function
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "expression.hpp"
+#include "output.hpp"
+#include "result.hpp"
+
+//! The number of error codes (E1 to E9)
+static const int ERRORS = 9;
+//! The tries to build a line with the asked outcome
+static const unsigned TRIES = 32;
+//! The lines kept to be repeated by the duplicates
+static const std::size_t POOL_SIZE = 4096;
+
+/**
+ * @brief The generator options
+ */
+struct Options {
+    unsigned long lines = 1000;      //!< The number of lines
+    unsigned long seed = 42;         //!< The random numbers seed
+    unsigned min_operands = 1;       //!< The minimum operands by line
+    unsigned max_operands = 16;      //!< The maximum operands by line
+    unsigned long numbers = 999;     //!< The maximum operand
+    unsigned depth = 4;              //!< The maximum nesting depth
+    double parentheses = 0.25;       //!< The chance of a nested group
+    double unary = 0.05;             //!< The chance of a unary minus
+    std::string operators = "+-*/%^";  //!< The operators (by weight)
+    double errors[ERRORS] = {};      //!< The fraction of lines by error
+    double duplicates = 0;           //!< The fraction of repeated lines
+};
+
+/**
+ * @brief Draw a number below a bound
+ * @param _rng The random numbers generator
+ * @param _bound The bound (greater than 0)
+ * @return A number in [0, _bound)
+ *
+ * Unlike the std distributions, gives the same numbers on every standard
+ * library, so a seed always generates the same files
+ */
+static unsigned long below(std::mt19937_64 &_rng, unsigned long _bound) {
+    return _rng() % _bound;
+}
+
+/**
+ * @brief Draw a number in [0, 1)
+ * @param _rng The random numbers generator
+ * @return The number (portable, as below)
+ */
+static double fraction(std::mt19937_64 &_rng) {
+    return static_cast<double>(_rng() >> 11) / static_cast<double>(1ull << 53);
+}
+
+/**
+ * @brief Append a random operand
+ * @param _rng The random numbers generator
+ * @param _options The generator options
+ * @param _operator The operator before the operand (or 0)
+ * @param _expr The expression to append
+ *
+ * The operands of '^' are small and the ones of '/' and '%' aren't zero,
+ * so most clean lines don't overflow nor divide by zero
+ */
+static void operand(std::mt19937_64 &_rng, const Options &_options,
+                    char _operator, std::string &_expr) {
+    if (_operator == '^') {
+        _expr += std::to_string(below(_rng, 4));
+        return;
+    }
+    if (fraction(_rng) < _options.unary)
+        _expr += '-';
+    if (_operator == '/' || _operator == '%')
+        _expr += std::to_string(1 + below(_rng, _options.numbers));
+    else
+        _expr += std::to_string(below(_rng, _options.numbers + 1));
+}
+
+/**
+ * @brief Append a random expression
+ * @param _rng The random numbers generator
+ * @param _options The generator options
+ * @param _operands The number of operands (at least 1)
+ * @param _depth The nesting depth left
+ * @param _expr The expression to append
+ *
+ * A chain of operands and groups, where a group is a nested expression
+ * (so the recursion is only as deep as the nesting). There are no groups
+ * after '/', '%' and '^', since they could be zero or large.
+ */
+static void expression(std::mt19937_64 &_rng, const Options &_options,
+                       unsigned _operands, unsigned _depth,
+                       std::string &_expr) {
+    char _operator = 0;
+    while (_operands > 0) {
+        if (_operator != 0)
+            _expr.append(1, ' ').append(1, _operator).append(1, ' ');
+        bool _nest = _operator == 0 || !std::strchr("/%^", _operator);
+        if (_operands > 1 && _depth > 0 && _nest &&
+            fraction(_rng) < _options.parentheses) {
+            unsigned _group = 2 + below(_rng, _operands - 1);
+            _expr += '(';
+            expression(_rng, _options, _group, _depth - 1, _expr);
+            _expr += ')';
+            _operands -= _group;
+        } else {
+            operand(_rng, _options, _operator, _expr);
+            _operands--;
+        }
+        _operator = _options.operators[below(_rng, _options.operators.size())];
+    }
+}
+
+/**
+ * @brief Add an error to a clean expression
+ * @param _error The error id (0 for E1, ..., 8 for E9)
+ * @param _expr The expression (with at least one operand)
+ * @return The expression with the error
+ */
+static std::string with_error(int _error, const std::string &_expr) {
+    switch (_error) {
+        case 0: return _expr + " + 40000";
+        case 1: return _expr + " +";
+        case 2: return _expr + " + ($)";
+        case 3: return _expr + " 7";
+        case 4: return _expr + ")";
+        case 5: return "* " + _expr;
+        case 6: return "(" + _expr;
+        case 7: return "(" + _expr + ") / 0";
+        default: return "32767 * 2 + " + _expr;
+    }
+}
+
+/**
+ * @brief Parse a range of operands
+ * @param _arg The range (e.g. "1:16", or "8" for a fixed number)
+ * @param _options The options to keep the range
+ * @return True if is a valid range, False otherwise
+ */
+static bool parse_operands(const char *_arg, Options &_options) {
+    char *_end;
+    _options.min_operands = std::strtoul(_arg, &_end, 10);
+    _options.max_operands = _options.min_operands;
+    if (*_end == ':')
+        _options.max_operands = std::strtoul(_end + 1, &_end, 10);
+    return *_end == '\0' && _options.min_operands <= _options.max_operands;
+}
+
+/**
+ * @brief Parse an error rate
+ * @param _arg The error and its fraction of lines (e.g. "E8=0.01")
+ * @param _options The options to keep the rate
+ * @return True if is a valid rate, False otherwise
+ */
+static bool parse_error(const char *_arg, Options &_options) {
+    if (_arg[0] != 'E' || _arg[1] < '1' || _arg[1] > '9' || _arg[2] != '=')
+        return false;
+    char *_end;
+    double _rate = std::strtod(_arg + 3, &_end);
+    if (*_end != '\0' || _rate < 0 || _rate > 1)
+        return false;
+    _options.errors[_arg[1] - '1'] = _rate;
+    return true;
+}
+
+/**
+ * @brief Print the usage
+ */
+static void usage() {
+    std::cerr
+        << "Usage: generate [options] input_file [expected_file]\n"
+        << "  --lines N            number of lines (default 1000)\n"
+        << "  --seed N             random numbers seed (default 42)\n"
+        << "  --operands MIN:MAX   operands by line (default 1:16)\n"
+        << "  --numbers MAX        maximum operand (default 999)\n"
+        << "  --depth N            maximum nesting depth (default 4)\n"
+        << "  --parentheses P      chance of a nested group (default 0.25)\n"
+        << "  --unary P            chance of a unary minus (default 0.05)\n"
+        << "  --operators OPS      operators, repeat one to weight it "
+        << "(default +-*/%^)\n"
+        << "  --error En=P         fraction of lines with the error En "
+        << "(repeatable)\n"
+        << "  --duplicates P       fraction of repeated lines (default 0)\n";
+}
+
+/**
+ * @brief Main function
+ *
+ * Writes a synthetic input file, with one expression by line, and the
+ * expected output of each line (as bares writes it, computed with the
+ * current Expression::calculate). The same options and seed always
+ * generate the same files.
+ *
+ * Each line is either a repetition of an earlier line, a clean line (no
+ * error, retried a few times when it overflows) or a clean line with the
+ * asked error added (retried until it gives that error). The number of
+ * lines by outcome is printed at the end.
+ *
+ * Usage: generate [options] input_file [expected_file]
+ */
+int main(int argc, char const *argv[]) {
+    Options options;
+    std::vector<std::string> files;
+
+    for (auto i(1); i < argc; i++) {
+        std::string arg(argv[i]);
+        bool valid = true;
+        if (arg.compare(0, 2, "--") == 0 && i + 1 == argc) {
+            valid = false;
+        } else if (arg == "--lines") {
+            options.lines = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--seed") {
+            options.seed = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--operands") {
+            valid = parse_operands(argv[++i], options);
+        } else if (arg == "--numbers") {
+            options.numbers = std::strtoul(argv[++i], nullptr, 10);
+            valid = options.numbers > 0;
+        } else if (arg == "--depth") {
+            options.depth = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--parentheses") {
+            options.parentheses = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--unary") {
+            options.unary = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--operators") {
+            options.operators = argv[++i];
+            valid = !options.operators.empty() &&
+                    options.operators.find_first_not_of("+-*/%^") ==
+                        std::string::npos;
+        } else if (arg == "--error") {
+            valid = parse_error(argv[++i], options);
+        } else if (arg == "--duplicates") {
+            options.duplicates = std::strtod(argv[++i], nullptr);
+        } else if (arg.compare(0, 2, "--") == 0) {
+            valid = false;
+        } else {
+            files.push_back(arg);
+        }
+        if (!valid) {
+            std::cerr << "Invalid option: " << arg << "\n";
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    double _errors = 0;
+    for (auto _rate : options.errors)
+        _errors += _rate;
+    if (files.empty() || files.size() > 2 || _errors > 1) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    Output input(files[0]);
+    std::unique_ptr<Output> expected;
+    if (files.size() == 2)
+        expected.reset(new Output(files[1]));
+    if (!input.good() || (expected && !expected->good())) {
+        std::cerr << "The file specified cannot be opened.\n";
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937_64 rng(options.seed);
+    Expression expr{std::string_view()};
+    std::vector<std::pair<std::string, Result>> pool;
+    unsigned long outcomes[ERRORS + 1] = {};  // By error id, clean last
+    unsigned long repeated = 0;
+    std::string line;
+    Result result;
+
+    for (auto n(0ul); n < options.lines; n++) {
+        if (!pool.empty() && fraction(rng) < options.duplicates) {
+            const auto &_line = pool[below(rng, pool.size())];
+            line = _line.first;
+            result = _line.second;
+            repeated++;
+        } else {
+            // The outcome of the line: an error id, or -1 for a clean line
+            int _error = -1;
+            double _draw = fraction(rng);
+            for (auto e(0); e < ERRORS && _error == -1; e++)
+                if ((_draw -= options.errors[e]) < 0)
+                    _error = e;
+
+            for (auto _try(0u); _try < TRIES; _try++) {
+                unsigned _operands = options.min_operands +
+                    below(rng, options.max_operands - options.min_operands + 1);
+                line.clear();
+                if (_operands == 0 && _error != -1)
+                    _operands = 1;
+                if (_operands > 0)
+                    expression(rng, options, _operands, options.depth, line);
+                if (_error != -1)
+                    line = with_error(_error, line);
+                expr.reset(line);
+                expr.calculate(result);
+                if (result.error == _error)
+                    break;
+            }
+            if (pool.size() < POOL_SIZE)
+                pool.emplace_back(line, result);
+            else
+                pool[below(rng, POOL_SIZE)] = {line, result};
+        }
+
+        outcomes[result.is_error() ? result.error : ERRORS]++;
+        input.write(line);
+        input.write("\n");
+        if (expected)
+            expected->write(result);
+    }
+
+    if (!input.flush() || (expected && !expected->flush())) {
+        std::cerr << "The files couldn't be written.\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cerr << "Lines: " << options.lines << " (" << repeated
+              << " repeated)\nClean: " << outcomes[ERRORS] << "\n";
+    for (auto e(0); e < ERRORS; e++)
+        if (outcomes[e] > 0)
+            std::cerr << "E" << e + 1 << ": " << outcomes[e] << "\n";
+
+    return EXIT_SUCCESS;
+}
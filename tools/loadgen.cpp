@@ -0,0 +1,302 @@
+/*!
+ *  @file loadgen.cpp
+ *  @brief Load Generator File
+ *  @copyright Copyright &copy; 2016. All rights reserved.
+ *
+ *  File with the server load generator main function
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "input.hpp"
+
+//! The clock of the latencies
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief The load options
+ */
+struct Options {
+    std::string path;              //!< The Unix socket path (or empty)
+    unsigned port = 0;             //!< The loopback TCP port (or 0)
+    unsigned connections = 4;      //!< The number of connections
+    unsigned long requests = 100000;  //!< The requests by connection
+    unsigned pipeline = 64;        //!< The requests in flight by connection
+};
+
+/**
+ * @brief The outcome of a connection
+ */
+struct Outcome {
+    std::vector<std::uint64_t> latencies;  //!< The latency of each request
+    unsigned long mismatches = 0;  //!< The responses not as expected
+    bool failed = false;           //!< Flag to indicate a socket error
+};
+
+/**
+ * @brief Connect to the server
+ * @param _options The load options (the socket path or port)
+ * @return The socket, or -1 if it can't connect
+ */
+static int connect_server(const Options &_options) {
+    int _fd;
+    if (!_options.path.empty()) {
+        sockaddr_un _address = {};
+        if (_options.path.size() >= sizeof(_address.sun_path))
+            return -1;
+        _address.sun_family = AF_UNIX;
+        std::memcpy(_address.sun_path, _options.path.c_str(),
+                    _options.path.size() + 1);
+        _fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (_fd >= 0 && connect(_fd, reinterpret_cast<sockaddr *>(&_address),
+                                sizeof(_address)) == 0)
+            return _fd;
+    } else {
+        sockaddr_in _address = {};
+        _address.sin_family = AF_INET;
+        _address.sin_port = htons(_options.port);
+        _address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        _fd = socket(AF_INET, SOCK_STREAM, 0);
+        int _on = 1;
+        if (_fd >= 0 && connect(_fd, reinterpret_cast<sockaddr *>(&_address),
+                                sizeof(_address)) == 0) {
+            setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &_on, sizeof(_on));
+            return _fd;
+        }
+    }
+    if (_fd >= 0)
+        close(_fd);
+    return -1;
+}
+
+/**
+ * @brief Send all bytes
+ * @param _fd The socket
+ * @param _data The bytes
+ * @return True if all succeed, False otherwise
+ */
+static bool send_all(int _fd, std::string_view _data) {
+    while (!_data.empty()) {
+        ssize_t _sent = send(_fd, _data.data(), _data.size(), MSG_NOSIGNAL);
+        if (_sent < 0 && errno == EINTR)
+            continue;
+        if (_sent <= 0)
+            return false;
+        _data.remove_prefix(_sent);
+    }
+    return true;
+}
+
+/**
+ * @brief Run the requests of a connection
+ * @param _options The load options
+ * @param _first The position of the first line sent
+ * @param _lines The lines to send (cycled)
+ * @param _expected The expected responses (or empty)
+ * @param _return Keep the latencies and the mismatches
+ *
+ * Keeps up to _options.pipeline requests in flight: sends the requests
+ * missing, and then reads the responses available
+ */
+static void run_connection(const Options &_options, std::size_t _first,
+                           const std::vector<std::string_view> &_lines,
+                           const std::vector<std::string_view> &_expected,
+                           Outcome &_return) {
+    int _fd = connect_server(_options);
+    if (_fd < 0) {
+        _return.failed = true;
+        return;
+    }
+
+    std::vector<Clock::time_point> _sent_at(_options.pipeline);
+    std::string _requests, _response;
+    std::vector<char> _buffer(1 << 16);
+    unsigned long _sent = 0, _received = 0;
+    _return.latencies.reserve(_options.requests);
+
+    while (_received < _options.requests) {
+        _requests.clear();
+        auto _now = Clock::now();
+        while (_sent < _options.requests &&
+               _sent - _received < _options.pipeline) {
+            _requests.append(_lines[(_first + _sent) % _lines.size()]);
+            _requests += '\n';
+            _sent_at[_sent % _options.pipeline] = _now;
+            _sent++;
+        }
+        if (!send_all(_fd, _requests)) {
+            _return.failed = true;
+            break;
+        }
+
+        ssize_t _read = recv(_fd, _buffer.data(), _buffer.size(), 0);
+        if (_read < 0 && errno == EINTR)
+            continue;
+        if (_read <= 0) {
+            _return.failed = true;
+            break;
+        }
+        _now = Clock::now();
+        for (const char *_c = _buffer.data(); _c < _buffer.data() + _read;
+             _c++) {
+            if (*_c != '\n') {
+                _response += *_c;
+                continue;
+            }
+            auto _latency = _now - _sent_at[_received % _options.pipeline];
+            _return.latencies.push_back(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(_latency)
+                    .count());
+            if (!_expected.empty() &&
+                _response != _expected[(_first + _received) %
+                                       _expected.size()])
+                _return.mismatches++;
+            _response.clear();
+            _received++;
+        }
+    }
+    close(_fd);
+}
+
+/**
+ * @brief Read all lines of a file
+ * @param _input The Input (mapped, so the lines stay valid)
+ * @param _return Keep the lines
+ */
+static void read_lines(Input &_input, std::vector<std::string_view> &_return) {
+    std::string_view _line;
+    while (_input.next(_line))
+        _return.push_back(_line);
+}
+
+/**
+ * @brief Print the usage
+ */
+static void usage() {
+    std::cerr
+        << "Usage: loadgen [options] (--unix PATH | --tcp PORT) input_file "
+        << "[expected_file]\n"
+        << "  --connections N   concurrent connections (default 4)\n"
+        << "  --requests N      requests by connection (default 100000)\n"
+        << "  --pipeline N      requests in flight by connection "
+        << "(default 64, at most 4096)\n";
+}
+
+/**
+ * @brief Main function
+ *
+ * Sends the lines of the input file (cycled, each connection from another
+ * line) to a running server, on many connections at once, each one with
+ * many requests in flight. Prints the throughput and the percentiles of
+ * the latency (from sending a request to reading its response). With the
+ * expected file (e.g. written by generate), also verifies each response.
+ *
+ * Usage: loadgen [options] (--unix PATH | --tcp PORT) input_file
+ * [expected_file]
+ */
+int main(int argc, char const *argv[]) {
+    Options options;
+    std::vector<std::string> files;
+
+    for (auto i(1); i < argc; i++) {
+        std::string arg(argv[i]);
+        if (arg == "--unix" && i + 1 < argc)
+            options.path = argv[++i];
+        else if (arg == "--tcp" && i + 1 < argc)
+            options.port = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--connections" && i + 1 < argc)
+            options.connections = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--requests" && i + 1 < argc)
+            options.requests = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--pipeline" && i + 1 < argc)
+            options.pipeline = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg.compare(0, 2, "--") != 0)
+            files.push_back(arg);
+        else
+            options.connections = 0;
+    }
+    // An unknown option leaves no connections, and the responses in
+    // flight must fit on the server (see Server)
+    if (files.empty() || files.size() > 2 ||
+        (options.path.empty() && options.port == 0) ||
+        options.connections == 0 || options.pipeline == 0 ||
+        options.pipeline > 4096) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    Input input(files[0]);
+    Input expected(files.size() == 2 ? files[1] : files[0]);
+    std::vector<std::string_view> lines, responses;
+    if (!input.is_open() || !expected.is_open()) {
+        std::cerr << "The file specified cannot be opened.\n";
+        return EXIT_FAILURE;
+    }
+    read_lines(input, lines);
+    if (files.size() == 2)
+        read_lines(expected, responses);
+    if (lines.empty() || (files.size() == 2 &&
+                          responses.size() != lines.size())) {
+        std::cerr << "The files must have the same number of lines.\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Outcome> outcomes(options.connections);
+    std::vector<std::thread> threads;
+    auto start = Clock::now();
+    for (auto c(0u); c < options.connections; c++)
+        threads.emplace_back(run_connection, std::cref(options),
+                             c * lines.size() / options.connections,
+                             std::cref(lines), std::cref(responses),
+                             std::ref(outcomes[c]));
+    for (auto &_thread : threads)
+        _thread.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start)
+                         .count();
+
+    std::vector<std::uint64_t> latencies;
+    unsigned long mismatches = 0, failed = 0;
+    for (const auto &_outcome : outcomes) {
+        latencies.insert(latencies.end(), _outcome.latencies.begin(),
+                         _outcome.latencies.end());
+        mismatches += _outcome.mismatches;
+        failed += _outcome.failed;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double _p) {
+        if (latencies.empty())
+            return 0.0;
+        auto _rank = static_cast<std::size_t>(_p * (latencies.size() - 1));
+        return latencies[_rank] / 1e3;
+    };
+
+    std::cout << "Requests: " << latencies.size() << " in " << seconds
+              << " s (" << latencies.size() / seconds << " requests/s)\n"
+              << "Latency: p50 " << percentile(0.5) << " us, p99 "
+              << percentile(0.99) << " us, p99.9 " << percentile(0.999)
+              << " us, max " << percentile(1) << " us\n";
+    if (files.size() == 2)
+        std::cout << "Mismatches: " << mismatches << "\n";
+    if (failed > 0)
+        std::cerr << failed << " connections failed.\n";
+
+    return mismatches == 0 && failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}